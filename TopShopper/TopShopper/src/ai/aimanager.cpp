@@ -1,5 +1,9 @@
 #include "aimanager.h"
 #include "core/broker.h"
+#include "core/componentpools.h"
+#include "core/snapshot.h"
+#include "physics/pickupgrid.h"
+#include "utility/profiler.h"
 #include "PxPhysicsAPI.h"
 #include "objects/entity.h"
 #include "objects/milk.h"
@@ -141,19 +145,6 @@ void AIManager::loadScene1() {
 }
 
 void AIManager::cleanupScene1() {
-	_cookieLocations.clear();
-	_mysteryBagLocations.clear();
-	_spareChangeLocations.clear();
-	_milkLocations.clear();
-	_waterLocations.clear();
-	_colaLocations.clear();
-	_appleLocations.clear();
-	_watermelonLocations.clear();
-	_bananaLocations.clear();
-	_carrotLocations.clear();
-	_eggplantLocations.clear();
-	_broccoliLocations.clear();
-
 	_cookieCanSpawn = true;
 	_startingCookie = nullptr;
 
@@ -184,26 +175,20 @@ void AIManager::cleanupScene1() {
 
 
 void AIManager::updateSeconds(double variableDeltaTime) {
-	// call UPDATE() for all behaviour scripts...
-	std::vector<std::shared_ptr<Entity>> entitiesCopy = _broker->getPhysicsManager()->getActiveScene()->_entities;
-	for (std::shared_ptr<Entity> &entity : entitiesCopy) {
-		std::shared_ptr<Component> comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-		if (comp != nullptr) {
-			std::shared_ptr<BehaviourScript> script = std::static_pointer_cast<BehaviourScript>(comp);
-			script->update(variableDeltaTime);
-		}
+	PROFILE_SCOPE("AIManager::updateSeconds");
+	// call UPDATE() for the behaviour scripts that have one (see FrameCallbacks)...
+	std::vector<BehaviourScript*> &scripts = _broker->getPhysicsManager()->getActiveScene()->_componentPools->_updates._scripts;
+	size_t nbScripts = scripts.size(); // NOTE: scripts can spawn entities in here, so don't walk past the starting size
+	for (size_t i = 0; i < nbScripts; i++) {
+		scripts[i]->update(variableDeltaTime);
 	}
 
 
-	// FIND THE LOCATION OF EACH ITEM (COOKIE, MYSTERYBAG, SPARECHANGE, 9 LIST ITEMS) - EITHER IN WORLD OR ON A PLAYER...
-	updateLocations();
-
 	// HANDLE NEW SPAWNING...
 
 	if (_cookieCanSpawn && _startingCookie == nullptr) {
 		std::shared_ptr<Cookie> cookie = std::dynamic_pointer_cast<Cookie>(_broker->getPhysicsManager()->instantiateEntity(EntityTypes::COOKIE, _startingCookieSpawnPoint, "startingCookie"));
 		_startingCookie = cookie;
-		_cookieLocations.push_back(ItemLocation(_startingCookieSpawnPoint.p, true, ItemLocation::TargetTypes::COOKIE, cookie));
 	}
 
 	if (_mysteryBagCanSpawn && _mysteryBag == nullptr) {
@@ -211,7 +196,6 @@ void AIManager::updateSeconds(double variableDeltaTime) {
 		if (_mysteryBagSpawnTimer <= 0.0) {
 			std::shared_ptr<MysteryBag> mysteryBag = std::dynamic_pointer_cast<MysteryBag>(_broker->getPhysicsManager()->instantiateEntity(EntityTypes::MYSTERY_BAG, _mysteryBagSpawnPoint, "mysteryBag"));
 			_mysteryBag = mysteryBag;
-			_mysteryBagLocations.push_back(ItemLocation(_mysteryBagSpawnPoint.p, true, ItemLocation::TargetTypes::MYSTERY_BAG, mysteryBag));
 			_broker->getRenderingManager()->bagText = 75;
 		}
 	}
@@ -224,94 +208,83 @@ void AIManager::updateSeconds(double variableDeltaTime) {
 			if (spareChangeSpawnTimers.at(i) <= 0.0) {
 				std::shared_ptr<SpareChange> spareChange = std::dynamic_pointer_cast<SpareChange>(_broker->getPhysicsManager()->instantiateEntity(EntityTypes::SPARE_CHANGE, spareChangeSpawnPoints.at(i), "SpareChangeSP" + i));
 				spareChangeInstances.at(i) = spareChange;
-				_spareChangeLocations.push_back(ItemLocation(spareChangeSpawnPoints.at(i).p, true, ItemLocation::TargetTypes::OTHER, spareChange));
 			}
 		}
 	}
 
 
 	// NOTE: I'm not worrying about the entity names since duplicates dont matter in our game
-	while (_milkLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::MILK) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextDrinkSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> milk = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::MILK, drinkSpawnPoints.at(spawnIndex), "MilkSP"); 
 		drinkInstances.at(spawnIndex) = milk;
-		_milkLocations.push_back(ItemLocation(drinkSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, milk));
-
 	}
-	while (_waterLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::WATER) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextDrinkSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 		
 		std::shared_ptr<Entity> water = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::WATER, drinkSpawnPoints.at(spawnIndex), "WaterSP");
 		drinkInstances.at(spawnIndex) = water;
-		_waterLocations.push_back(ItemLocation(drinkSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, water));
 	}
-	while (_colaLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::COLA) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextDrinkSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> cola = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::COLA, drinkSpawnPoints.at(spawnIndex), "ColaSP");
 		drinkInstances.at(spawnIndex) = cola;
-		_colaLocations.push_back(ItemLocation(drinkSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, cola));
 	}
-	while (_appleLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::APPLE) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextFruitSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> apple = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::APPLE, fruitSpawnPoints.at(spawnIndex), "AppleSP");
 		fruitInstances.at(spawnIndex) = apple;
-		_appleLocations.push_back(ItemLocation(fruitSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, apple));
 	}
-	while (_watermelonLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::WATERMELON) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextFruitSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> watermelon = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::WATERMELON, fruitSpawnPoints.at(spawnIndex), "WatermelonSP");
 		fruitInstances.at(spawnIndex) = watermelon;
-		_watermelonLocations.push_back(ItemLocation(fruitSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, watermelon));
 	}
-	while (_bananaLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::BANANA) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextFruitSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> banana = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::BANANA, fruitSpawnPoints.at(spawnIndex), "BananaSP");
 		fruitInstances.at(spawnIndex) = banana;
-		_bananaLocations.push_back(ItemLocation(fruitSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, banana));
 	}
-	while (_carrotLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::CARROT) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextVeggieSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> carrot = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::CARROT, veggieSpawnPoints.at(spawnIndex), "CarrotSP");
 		veggieInstances.at(spawnIndex) = carrot;
-		_carrotLocations.push_back(ItemLocation(veggieSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, carrot));
 	}
-	while (_eggplantLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::EGGPLANT) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextVeggieSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> eggplant = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::EGGPLANT, veggieSpawnPoints.at(spawnIndex), "EggplantSP");
 		veggieInstances.at(spawnIndex) = eggplant;
-		_eggplantLocations.push_back(ItemLocation(veggieSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, eggplant));
 	}
-	while (_broccoliLocations.size() < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
+	while (getNbInstancesOfType(EntityTypes::BROCCOLI) < MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM) {
 		// spawn
 		int spawnIndex = getNextVeggieSpawnIndex();
 		if (-1 == spawnIndex) break; // fail the spawning for this frame
 
 		std::shared_ptr<Entity> broccoli = _broker->getPhysicsManager()->instantiateEntity(EntityTypes::BROCCOLI, veggieSpawnPoints.at(spawnIndex), "BroccoliSP");
 		veggieInstances.at(spawnIndex) = broccoli;
-		_broccoliLocations.push_back(ItemLocation(veggieSpawnPoints.at(spawnIndex).p, true, ItemLocation::TargetTypes::OTHER, broccoli));
 	}
 
 
@@ -374,101 +347,25 @@ void AIManager::updateSeconds(double variableDeltaTime) {
 }
 
 
-void AIManager::updateLocations() {
-	_cookieLocations.clear();
-	_mysteryBagLocations.clear();
-	_spareChangeLocations.clear();
-	_milkLocations.clear();
-	_waterLocations.clear();
-	_colaLocations.clear();
-	_appleLocations.clear();
-	_watermelonLocations.clear();
-	_bananaLocations.clear();
-	_carrotLocations.clear();
-	_eggplantLocations.clear();
-	_broccoliLocations.clear();
-
-	for (const std::shared_ptr<Entity> &entity : _broker->getPhysicsManager()->getActiveScene()->_entities) {
-		
-		if (entity->getDestroyFlag()) continue; // ignore entities that were flagged for destroy at the end og this scene
-		
-		switch (entity->getTag()) {
-			case EntityTypes::SHOPPING_CART_PLAYER:
-			{
-				std::shared_ptr<PlayerScript> playerScript = std::static_pointer_cast<PlayerScript>(entity->getComponent(ComponentTypes::PLAYER_SCRIPT));
-				for (int i = 0; i < 3; i++) {
-					if (playerScript->_shoppingList_Flags.at(i)) {
-						switch (playerScript->_shoppingList_Types.at(i)) {
-							case EntityTypes::MILK:
-								_milkLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::WATER:
-								_waterLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::COLA:
-								_colaLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::APPLE:
-								_appleLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::WATERMELON:
-								_watermelonLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::BANANA:
-								_bananaLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::CARROT:
-								_carrotLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::EGGPLANT:
-								_eggplantLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-							case EntityTypes::BROCCOLI:
-								_broccoliLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, false, ItemLocation::TargetTypes::OTHER, entity));
-								break;
-						}
-					}
-				}
-				break;
-			}
-			case EntityTypes::COOKIE:
-				_cookieLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::COOKIE, entity));
-				break;
-			case EntityTypes::MYSTERY_BAG:
-				_mysteryBagLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::MYSTERY_BAG, entity));
-				break;
-			case EntityTypes::SPARE_CHANGE:
-				_spareChangeLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::MILK:
-				_milkLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::WATER:
-				_waterLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::COLA:
-				_colaLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::APPLE:
-				_appleLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::WATERMELON:
-				_watermelonLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::BANANA:
-				_bananaLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::CARROT:
-				_carrotLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::EGGPLANT:
-				_eggplantLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
-			case EntityTypes::BROCCOLI:
-				_broccoliLocations.push_back(ItemLocation(entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, entity));
-				break;
+// in world (resting or knocked loose) + held by players...
+int AIManager::getNbInstancesOfType(EntityTypes type) {
+	GameScene *scene = _broker->getPhysicsManager()->getActiveScene().get();
+
+	int nbInstances = 0;
+	for (const std::shared_ptr<Entity> &entity : scene->getEntitiesOfType(type)) {
+		if (!entity->getDestroyFlag()) nbInstances++;
+	}
+
+	for (const std::shared_ptr<ShoppingCartPlayer> &cart : scene->getAllShoppingCartPlayers()) {
+		if (cart->getDestroyFlag()) continue; // ignore entities that were flagged for destroy at the end og this scene
+
+		PlayerScript *playerScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		for (int i = 0; i < 3; i++) {
+			if (playerScript->shoppingListFlags().at(i) && playerScript->shoppingListTypes().at(i) == type) nbInstances++;
 		}
 	}
+
+	return nbInstances;
 }
 
 
@@ -512,11 +409,11 @@ int AIManager::getNextVeggieSpawnIndex() {
 void AIManager::setNewAITargets() {
 	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	for (std::shared_ptr<ShoppingCartPlayer> player : players) {
-		std::shared_ptr<PlayerScript> playerScript = std::static_pointer_cast<PlayerScript>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
-		if (playerScript->_playerType == PlayerScript::BOT) {
+		PlayerScript *playerScript = static_cast<PlayerScript*>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		if (playerScript->isAIControlled()) {
 
 			// 0. IF AN AI HAS THE HOT POTATO THEY WILL SIMPLY TRY TO FIND THE NEAREST (NON BASH_PROTECTED) PLAYER TO BASH AND PASS ON THE HOT POTATO...
-			if (playerScript->_hasHotPotato) {
+			if (playerScript->hasHotPotato()) {
 
 				bool getNewTarget = true; // assume AI needs to seek a new target...
 				if (playerScript->_targets.size() > 0) {
@@ -539,8 +436,8 @@ void AIManager::setNewAITargets() {
 						if (player == otherPlayer) continue; // ignore comparison with self...
 						if (otherPlayer->_shoppingCartBase->IsBashProtected()) continue; // ignore comparison with bash protected carts...
 
-						std::shared_ptr<PlayerScript> otherPlayerScript = std::static_pointer_cast<PlayerScript>(otherPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT)); \
-						int otherPlayerPoints = otherPlayerScript->_points;
+						PlayerScript *otherPlayerScript = static_cast<PlayerScript*>(otherPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT)); \
+						int otherPlayerPoints = otherPlayerScript->points();
 						if (otherPlayerPoints > topPoints) {
 							topPoints = otherPlayerPoints;
 							topScorer = otherPlayer;
@@ -556,108 +453,68 @@ void AIManager::setNewAITargets() {
 			else {
 				playerScript->_targets.clear();
 
+				GameScene *scene = _broker->getPhysicsManager()->getActiveScene().get();
+				PxVec3 playerPos = player->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
+				float separation = FLT_MAX;
+
 				// 1. IF STARTING COOKIE ON FIELD, DROP WHAT YOU'RE DOING AND SEEK IT OUT...
 
-				if (_cookieLocations.size() > 0) {
-					playerScript->_targets.push_back(_cookieLocations.at(0));
+				Entity *cookie = scene->_pickupGrid->findNearest(playerPos, EntityTypes::COOKIE, separation);
+				if (cookie != nullptr) {
+					playerScript->_targets.push_back(ItemLocation(cookie->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::COOKIE, scene->getEntity(cookie->_handle)));
 					continue;
 				}
 
 				// 2. IF MYSTERY BAG ON FIELD, DROP WHAT YOU'RE DOING AND SEEK IT OUT...
 
-				if (_mysteryBagLocations.size() > 0) {
-					playerScript->_targets.push_back(_mysteryBagLocations.at(0));
+				Entity *mysteryBag = scene->_pickupGrid->findNearest(playerPos, EntityTypes::MYSTERY_BAG, separation);
+				if (mysteryBag != nullptr) {
+					playerScript->_targets.push_back(ItemLocation(mysteryBag->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::MYSTERY_BAG, scene->getEntity(mysteryBag->_handle)));
 					continue;
 				}
 
 				// 3. SEEK OUT LIST ITEMS THAT YOU ARE MISSING...
 				// PRIORITY:
-				// A) CLOSEST WORLD ITEM
+				// A) CLOSEST WORLD ITEM (nearest of each missing type straight from the pickup grid)
 				// B) CLOSEST ITEM ON A PLAYER
+				// NOTE: only list items that the player needs are considered, this will also inherently prevent an AI from trying to infinitely seek out an APPLE (distance 0 from them) while they already have an APPLE
 
-				// target candidates will only contain list items that the player needs...
-				std::vector<ItemLocation> targetCandidates;
-
-				// loop over player's list...
-				for (int i = 0; i < 3; i++) {
-					if (!playerScript->_shoppingList_Flags.at(i)) { // see which items the player needs to complete their list... NOTE: this will also inherently prevent an AI from trying to infinitely seek out an APPLE (distance 0 from them) while they already have an APPLE
-						switch (playerScript->_shoppingList_Types.at(i)) {
-						case EntityTypes::MILK:
-							for (ItemLocation loc : _milkLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::WATER:
-							for (ItemLocation loc : _waterLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::COLA:
-							for (ItemLocation loc : _colaLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::APPLE:
-							for (ItemLocation loc : _appleLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::WATERMELON:
-							for (ItemLocation loc : _watermelonLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::BANANA:
-							for (ItemLocation loc : _bananaLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::CARROT:
-							for (ItemLocation loc : _carrotLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::EGGPLANT:
-							for (ItemLocation loc : _eggplantLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						case EntityTypes::BROCCOLI:
-							for (ItemLocation loc : _broccoliLocations) {
-								targetCandidates.push_back(loc);
-							}
-							break;
-						}
-					}
-				}
-
-
-				PxVec3 playerPos = player->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
 				ItemLocation closestTarget;
 				bool targetFound = false;
 				float smallestSeparation = FLT_MAX;
 
-				for (ItemLocation loc : targetCandidates) {
-					if (!targetFound) {
+				// A)... (NOTE: items knocked loose out of a cart only become targets once they land again, they're not in the grid while they fly)
+				for (int i = 0; i < 3; i++) {
+					if (playerScript->shoppingListFlags().at(i)) continue;
+
+					Entity *item = scene->_pickupGrid->findNearest(playerPos, playerScript->shoppingListTypes().at(i), separation);
+					if (item != nullptr && separation < smallestSeparation) {
 						targetFound = true;
-						float separation = (loc._pos - playerPos).magnitude();
 						smallestSeparation = separation;
-						closestTarget = loc;
+						closestTarget = ItemLocation(item->_actor->is<PxRigidDynamic>()->getGlobalPose().p, true, ItemLocation::TargetTypes::OTHER, scene->getEntity(item->_handle));
 					}
-					else {
-						if (closestTarget._inWorld == loc._inWorld) {
-							// tiebreak on closest...
-							float separation = (loc._pos - playerPos).magnitude();
-							if (separation < smallestSeparation) {
+				}
+
+				// B)... (a cart holds an item when the flag for it is set on its own list)
+				if (!targetFound) {
+					for (std::shared_ptr<ShoppingCartPlayer> otherPlayer : players) {
+						if (player == otherPlayer || otherPlayer->getDestroyFlag()) continue;
+
+						PxVec3 otherPlayerPos = otherPlayer->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
+						separation = (otherPlayerPos - playerPos).magnitude();
+						if (separation >= smallestSeparation) continue;
+
+						PlayerScript *otherPlayerScript = static_cast<PlayerScript*>(otherPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
+						for (int i = 0; i < 3; i++) {
+							if (playerScript->shoppingListFlags().at(i)) continue;
+
+							for (int j = 0; j < 3; j++) {
+								if (!otherPlayerScript->shoppingListFlags().at(j) || otherPlayerScript->shoppingListTypes().at(j) != playerScript->shoppingListTypes().at(i)) continue;
+								targetFound = true;
 								smallestSeparation = separation;
-								closestTarget = loc;
+								closestTarget = ItemLocation(otherPlayerPos, false, ItemLocation::TargetTypes::OTHER, otherPlayer);
 							}
 						}
-						else if (!closestTarget._inWorld && loc._inWorld) {
-							float separation = (loc._pos - playerPos).magnitude();
-							smallestSeparation = separation;
-							closestTarget = loc;
-						}
 					}
 				}
 
@@ -670,6 +527,68 @@ void AIManager::setNewAITargets() {
 }
 
 
+void AIManager::writeSnapshot(SnapshotWriter &writer) {
+	writer.write(_matchTimer);
+
+	writer.write(_cookieCanSpawn);
+	writer.write(getSnapshotHandle(_startingCookie.get()));
+
+	writer.write(_mysteryBagCanSpawn);
+	writer.write(getSnapshotHandle(_mysteryBag.get()));
+	writer.write(_mysteryBagSpawnTimer);
+
+	for (int i = 0; i < NB_SPARE_CHANGE_SPAWN_POINTS; i++) {
+		writer.write(getSnapshotHandle(spareChangeInstances.at(i).get()));
+		writer.write(spareChangeSpawnTimers.at(i));
+	}
+	for (std::shared_ptr<Entity> &e : drinkInstances) writer.write(getSnapshotHandle(e.get()));
+	for (std::shared_ptr<Entity> &e : fruitInstances) writer.write(getSnapshotHandle(e.get()));
+	for (std::shared_ptr<Entity> &e : veggieInstances) writer.write(getSnapshotHandle(e.get()));
+}
+
+
+bool AIManager::readSnapshot(SnapshotReader &reader) {
+	PhysicsManager *physicsManager = _broker->getPhysicsManager();
+	EntityHandle handle;
+
+	reader.read(_matchTimer);
+
+	reader.read(_cookieCanSpawn);
+	reader.read(handle);
+	_startingCookie = std::dynamic_pointer_cast<Cookie>(physicsManager->resolveSnapshotHandle(handle));
+
+	reader.read(_mysteryBagCanSpawn);
+	reader.read(handle);
+	_mysteryBag = std::dynamic_pointer_cast<MysteryBag>(physicsManager->resolveSnapshotHandle(handle));
+	reader.read(_mysteryBagSpawnTimer);
+
+	for (int i = 0; i < NB_SPARE_CHANGE_SPAWN_POINTS; i++) {
+		reader.read(handle);
+		spareChangeInstances.at(i) = std::dynamic_pointer_cast<SpareChange>(physicsManager->resolveSnapshotHandle(handle));
+		reader.read(spareChangeSpawnTimers.at(i));
+	}
+	for (std::shared_ptr<Entity> &e : drinkInstances) {
+		reader.read(handle);
+		e = physicsManager->resolveSnapshotHandle(handle);
+	}
+	for (std::shared_ptr<Entity> &e : fruitInstances) {
+		reader.read(handle);
+		e = physicsManager->resolveSnapshotHandle(handle);
+	}
+	for (std::shared_ptr<Entity> &e : veggieInstances) {
+		reader.read(handle);
+		e = physicsManager->resolveSnapshotHandle(handle);
+	}
+
+	return !reader.hasFailed();
+}
+
+
+EntityHandle AIManager::getSnapshotHandle(Entity *entity) {
+	return entity != nullptr ? entity->_handle : EntityHandle();
+}
+
+
 std::string AIManager::getMatchTimePrettyFormat() {
 	int timeCeiling = (int) ceil(_matchTimer);
 	int minutes = timeCeiling / 60;
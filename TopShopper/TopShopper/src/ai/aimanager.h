@@ -14,6 +14,10 @@ class Entity;
 class SpareChange;
 class Cookie;
 class MysteryBag;
+class SnapshotWriter;
+class SnapshotReader;
+struct EntityHandle;
+enum EntityTypes;
 
 
 
@@ -29,28 +33,16 @@ public:
 
 	std::string getMatchTimePrettyFormat();
 
+	// SNAPSHOTS: spawn flags/timers + match timer, spawned instances are saved as entity handles
+	// NOTE: read after the physics manager's section, since the handles get resolved through PhysicsManager::resolveSnapshotHandle()
+	void writeSnapshot(SnapshotWriter &writer);
+	bool readSnapshot(SnapshotReader &reader);
+
 private:
 	Broker *_broker = nullptr;
 
-	// update these vectors every frame...
-	void updateLocations();
-	// ITEM LOCATIONS (either physically in world or on a player...)
-	
-	// ONLY IN WORLD...
-	std::vector<ItemLocation> _cookieLocations;
-	std::vector<ItemLocation> _mysteryBagLocations;
-	std::vector<ItemLocation> _spareChangeLocations;
-
-	// BOTH POSSIBLE...
-	std::vector<ItemLocation> _milkLocations;
-	std::vector<ItemLocation> _waterLocations;
-	std::vector<ItemLocation> _colaLocations;
-	std::vector<ItemLocation> _appleLocations;
-	std::vector<ItemLocation> _watermelonLocations;
-	std::vector<ItemLocation> _bananaLocations;
-	std::vector<ItemLocation> _carrotLocations;
-	std::vector<ItemLocation> _eggplantLocations;
-	std::vector<ItemLocation> _broccoliLocations;
+	// NOTE: world item targets come straight from the physics manager's PickupGrid (see setNewAITargets())
+	int getNbInstancesOfType(EntityTypes type); // in world + held by players, the spawners keep this at MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM
 
 	static const int MAX_NB_INSTANCES_OF_EACH_GROCERY_ITEM = 1; // WARNING: if I increase this in the future, I need to increase NB_SPAWN_POINTS for each item...
 
@@ -93,6 +85,8 @@ private:
 
 	void setNewAITargets();
 
+	EntityHandle getSnapshotHandle(Entity *entity); // null handle for nullptr
+
 	double _matchTimer = 300; // 5min (300s) match
 };
 
@@ -1,6 +1,7 @@
 
 #include "audiomanager.h"
 #include "core/broker.h"
+#include "utility/profiler.h"
 
 #include <iostream>
 #include <string>
@@ -32,6 +33,7 @@ AudioManager::AudioManager(Broker *broker)
 }
 
 AudioManager::~AudioManager() {
+	if (_broker->_headless) return;
 	// quit SDL_mixer
 	Mix_Quit();
 }
@@ -72,6 +74,7 @@ AudioManager::SoundEffect* AudioManager::getSoundEffect(SoundEffectTypes sound)
 }
 
 void AudioManager::changeBGM(BGMTypes BGM) {
+	if (_broker->_headless) return;
 	switch (BGM) {
 	case BGMTypes::END_SCENE:
 		bgm.music = loadMusic("resources/sfx/elevatorMusic.mp3");
@@ -125,6 +128,7 @@ Mix_Chunk* AudioManager::loadSFX(string filename) {
 
 // play myMusic
 void AudioManager::playMusic(Music *myMusic) {
+	if (_broker->_headless) return;
 	Mix_VolumeMusic(myMusic->volume);
 	//Mix_PlayMusic(myMusic->music, myMusic->loop);
 	if (Mix_PlayMusic(myMusic->music, myMusic->loop) == -1) {
@@ -134,22 +138,26 @@ void AudioManager::playMusic(Music *myMusic) {
 
 // pause music
 void AudioManager::pauseMusic() {
+	if (_broker->_headless) return;
 	if (Mix_PlayingMusic() != 0)
 		Mix_PauseMusic();
 }
 
 // resume the paused music
 void AudioManager::resumeMusic() {
+	if (_broker->_headless) return;
 	if (Mix_PausedMusic() != 0)
 		Mix_ResumeMusic();
 }
 
 void AudioManager::changeVolumeSFX(SoundEffect *mySfx, int volume) {
+	if (_broker->_headless) return;
 	//mySfx->volume = volume;
 	Mix_Volume(mySfx->channel, volume);
 }
 
 void AudioManager::assignFreeChanel(SoundEffect *mySfx) {
+	if (_broker->_headless) return;
 	if (Mix_Playing(mySfx->channel)) {
 		for (int i = 8; i < 20; i++) {
 			if (!Mix_Playing(i)) {
@@ -161,31 +169,37 @@ void AudioManager::assignFreeChanel(SoundEffect *mySfx) {
 }
 
 void AudioManager::changeDistanceSFX(SoundEffect *mySfx, float distance, float angle) {
+	if (_broker->_headless) return;
 	//mySfx->volume = volume;
 	Mix_SetPosition(mySfx->channel, (Sint16)angle, (Uint8)distance);
 }
 
 void AudioManager::haltSFX(SoundEffect *mySfx) {
+	if (_broker->_headless) return;
 	if (Mix_Playing(mySfx->channel)) {
 		Mix_FadeOutChannel(mySfx->channel, 15);
 	}
 }
 
 void AudioManager::pauseAllSFX() {
+	if (_broker->_headless) return;
 	Mix_Pause(-1);
 }
 
 void AudioManager::resumeAllSFX() {
+	if (_broker->_headless) return;
 	//cout << "before resume: " << Mix_Paused(-1) << endl;
 	Mix_Resume(-1);
 	//cout << "after resume: " << Mix_Paused(-1) << endl;
 }
 
 void AudioManager::resetAudio() {
+	if (_broker->_headless) return;
 	Mix_HaltChannel(-1);
 }
 
 void AudioManager::playSFX(SoundEffect *mySfx) {
+	if (_broker->_headless) return;
 	if (!Mix_Playing(mySfx->channel)) {
 		//Mix_SetPosition(mySfx->channel, mySfx->angle, mySfx->distance);
 		Mix_PlayChannel(mySfx->channel, mySfx->sfx, mySfx->loop);
@@ -196,6 +210,7 @@ void AudioManager::playSFX(SoundEffect *mySfx) {
 }
 
 void AudioManager::init() {
+	if (_broker->_headless) return; // NULL BACKEND: SDL is never initialized, every SFX/BGM call below becomes a no-op
 
 	// init SDL
 	SDL_Init(SDL_INIT_AUDIO);
@@ -304,6 +319,8 @@ float AudioManager::getAngle(glm::vec3 a, glm::vec3 b) {
 }
 
 void AudioManager::updateSeconds(double variableDeltaTime) {
+	PROFILE_SCOPE("AudioManager::updateSeconds");
+	if (_broker->_headless) return;
 	//playSFX(dropItemSound);
 	//float angle = getAngle(testV1, testV2);
 	//changeDistanceSFX(dropItemSound, 200, (Sint16)angle);
@@ -0,0 +1,309 @@
+#include "benchmark.h"
+#include "broker.h"
+#include "utility/allocationcounter.h"
+#include "utility/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+
+
+double BenchmarkSamples::getMean() {
+	if (_values.empty()) return 0.0;
+	double sum = 0.0;
+	for (double value : _values) sum += value;
+	return sum / _values.size();
+}
+
+
+double BenchmarkSamples::getPercentile(double percentile) {
+	if (_values.empty()) return 0.0;
+	std::vector<double> sorted = _values;
+	size_t rank = (size_t)ceil((percentile / 100.0) * sorted.size());
+	size_t index = rank > 0 ? rank - 1 : 0;
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+	return sorted.at(index);
+}
+
+
+double BenchmarkSamples::getMax() {
+	if (_values.empty()) return 0.0;
+	return *std::max_element(_values.begin(), _values.end());
+}
+
+
+
+int Benchmark::run(double fixedDeltaTime, double matchSeconds, const std::string &resultsPath) {
+	_broker->_autopilot = true; // player 1 drives itself with the bot AI, so every cart is a bot
+	_broker->getPhysicsManager()->_pipelined = false;
+
+	if (_broker->_warmRestart && !_broker->getPhysicsManager()->hasActiveScene()) {
+		// UNTIMED FIRST LOAD: so every scenario below is a warm restart, not just the 2nd one onwards...
+		srand(BENCHMARK_SEED);
+		_broker->startHeadlessMatch();
+		_broker->leaveMatch();
+	}
+
+	_scenarioResults.clear();
+	_scenarioResults.resize(NUMBER_OF_BENCHMARK_SCENARIOS);
+	for (int i = 0; i < NUMBER_OF_BENCHMARK_SCENARIOS; i++) {
+		ScenarioResults &scenarioResults = _scenarioResults.at(i);
+		runScenario((BenchmarkScenarios)i, fixedDeltaTime, matchSeconds, scenarioResults);
+
+		BenchmarkResults &results = scenarioResults._results;
+		std::cout << "BENCHMARK: " << getScenarioName(scenarioResults._scenario) << ": " << scenarioResults._nbSteps << " steps, "
+			<< (scenarioResults._wallSeconds > 0.0 ? scenarioResults._nbSteps / scenarioResults._wallSeconds : 0.0) << " steps/sec, "
+			<< "physics p50/p99 " << results._physicsUpdateMillis.getPercentile(50.0) << "/" << results._physicsUpdateMillis.getPercentile(99.0) << "ms, "
+			<< "ai p50/p99 " << results._aiUpdateMillis.getPercentile(50.0) << "/" << results._aiUpdateMillis.getPercentile(99.0) << "ms, "
+			<< results._allocationsPerStep.getMean() << " allocs/step, "
+			<< "pickup pool " << scenarioResults._pickupPoolStats.getHitRate() * 100.0 << "% hits" << std::endl;
+	}
+
+	if (Profiler::isEnabled()) {
+		Profiler::dumpChromeTrace("profile.json");
+	}
+
+	if (_broker->getPhysicsManager()->hasActiveScene()) {
+		// NOTE: keep in this order (same as Broker::leaveMatch())...
+		_broker->getPhysicsManager()->cleanupScene1();
+		_broker->getAIManager()->cleanupScene1();
+	}
+
+	return writeJson(resultsPath, fixedDeltaTime, matchSeconds) ? 0 : 1;
+}
+
+
+int Benchmark::runThreadScaling(double fixedDeltaTime, const std::string &resultsPath) {
+	InputReplay *inputReplay = _broker->getInputReplay();
+	if (!inputReplay->isPlaying()) {
+		std::cout << "ERROR: --thread-scaling needs a recorded match (--replay <file>)" << std::endl;
+		return 1;
+	}
+	if (inputReplay->getPipelined()) {
+		std::cout << "WARNING: replay was recorded with pipelined physics, it gets played back blocking so the step can be timed (expect desyncs)" << std::endl;
+	}
+	_broker->getPhysicsManager()->_pipelined = false;
+	_broker->_warmRestart = false; // every run gets a fresh PxScene built against the new worker count
+
+	JobSystem *jobSystem = _broker->getJobSystem();
+	unsigned int defaultNbWorkers = jobSystem->getNbWorkers();
+
+	_scalingResults.clear();
+	_scalingResults.resize(sizeof(SCALING_WORKER_COUNTS) / sizeof(SCALING_WORKER_COUNTS[0]));
+	for (size_t i = 0; i < _scalingResults.size(); i++) {
+		ScalingResults &scalingResults = _scalingResults.at(i);
+		runReplay(SCALING_WORKER_COUNTS[i], fixedDeltaTime, scalingResults);
+
+		BenchmarkResults &results = scalingResults._results;
+		std::cout << "THREAD SCALING: " << scalingResults._nbWorkers << " workers: " << scalingResults._nbFrames << " frames in " << scalingResults._wallSeconds << "s, "
+			<< "step p50/p99 " << results._physicsUpdateMillis.getPercentile(50.0) << "/" << results._physicsUpdateMillis.getPercentile(99.0) << "ms, "
+			<< "simulate p50 " << results._simulateMillis.getPercentile(50.0) << "ms, "
+			<< "fetchResults p50 " << results._fetchResultsMillis.getPercentile(50.0) << "ms, "
+			<< scalingResults._nbDesyncs << " desyncs" << std::endl;
+	}
+
+	jobSystem->setNbWorkers(defaultNbWorkers);
+
+	return writeScalingJson(resultsPath, fixedDeltaTime) ? 0 : 1;
+}
+
+
+
+void Benchmark::runScenario(BenchmarkScenarios scenario, double fixedDeltaTime, double matchSeconds, ScenarioResults &out) {
+	out._scenario = scenario;
+	_nextCoinStormTime = COIN_STORM_INTERVAL;
+
+	srand(BENCHMARK_SEED); // NOTE: before loading, the spawn point shuffle gets seeded from rand()
+	_broker->startHeadlessMatch();
+	_broker->_benchmarkResults = &out._results;
+
+	double simTime = 0.0;
+	double accumulator = 0.0;
+	double variableDeltaTime = fixedDeltaTime; // synthetic clock, 1 step per frame
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	while (_broker->_scene == GAME && simTime < matchSeconds) {
+		updateScenario(scenario, simTime);
+
+		accumulator += variableDeltaTime;
+		uint64_t nbAllocationsBefore = AllocationCounter::getNbAllocations();
+		_broker->updateAllSeconds(simTime, fixedDeltaTime, variableDeltaTime, accumulator);
+		if (AllocationCounter::isEnabled()) out._results._allocationsPerStep.add((double)(AllocationCounter::getNbAllocations() - nbAllocationsBefore));
+		out._nbSteps++;
+	}
+	out._wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	out._pickupPoolStats = _broker->getPhysicsManager()->getPickupPool()->getTotalStats();
+
+	_broker->_benchmarkResults = nullptr;
+	_broker->leaveMatch(); // parks the scene (warm restart) or tears it down (cold load), so the next scenario starts the same way as this one did
+}
+
+
+void Benchmark::runReplay(unsigned int nbWorkers, double fixedDeltaTime, ScalingResults &out) {
+	InputReplay *inputReplay = _broker->getInputReplay();
+	out._nbWorkers = nbWorkers;
+
+	_broker->getJobSystem()->setNbWorkers(nbWorkers); // NOTE: no scene loaded at this point, so nothing is in flight
+	_broker->startHeadlessMatch(); // rewinds the replay and reseeds rand()
+	_broker->_benchmarkResults = &out._results;
+
+	double simTime = 0.0;
+	double accumulator = 0.0;
+	double variableDeltaTime = fixedDeltaTime;
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	while (_broker->_scene == GAME) {
+		if (!inputReplay->nextFrame(variableDeltaTime, accumulator)) break;
+		_broker->updateAllSeconds(simTime, fixedDeltaTime, variableDeltaTime, accumulator);
+		out._nbFrames++;
+	}
+	out._wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	out._nbDesyncs = inputReplay->getNbDesyncs();
+
+	_broker->_benchmarkResults = nullptr;
+
+	_broker->getPhysicsManager()->cleanupScene1();
+	_broker->getAIManager()->cleanupScene1();
+}
+
+
+void Benchmark::updateScenario(BenchmarkScenarios scenario, double simTime) {
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+
+	switch (scenario) {
+		case BenchmarkScenarios::COIN_STORM:
+		{
+			if (simTime < _nextCoinStormTime) break;
+			_nextCoinStormTime += COIN_STORM_INTERVAL;
+			for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
+				static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT))->coinExplosion();
+			}
+			break;
+		}
+		case BenchmarkScenarios::HOT_POTATO_CHASE:
+		{
+			if (carts.empty()) break;
+			for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
+				if (static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT))->hasHotPotato()) return; // still in play
+			}
+			// last one exploded (or it's the first frame), hand out a new one...
+			const std::shared_ptr<ShoppingCartPlayer> &unluckyCart = carts.at(rand() % carts.size());
+			static_cast<PlayerScript*>(unluckyCart->getComponent(ComponentTypes::PLAYER_SCRIPT))->giveHotPotato(HOT_POTATO_DURATION);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+
+
+static void writeSamplesJson(std::ofstream &file, const char *name, BenchmarkSamples &samples, bool isLast) {
+	file << "\t\t\t\"" << name << "\": { "
+		<< "\"count\": " << samples._values.size() << ", "
+		<< "\"mean\": " << samples.getMean() << ", "
+		<< "\"p50\": " << samples.getPercentile(50.0) << ", "
+		<< "\"p95\": " << samples.getPercentile(95.0) << ", "
+		<< "\"p99\": " << samples.getPercentile(99.0) << ", "
+		<< "\"max\": " << samples.getMax() << " }" << (isLast ? "" : ",") << "\n";
+}
+
+
+bool Benchmark::writeJson(const std::string &resultsPath, double fixedDeltaTime, double matchSeconds) {
+	std::ofstream file(resultsPath, std::ios::trunc);
+	if (!file) {
+		std::cout << "ERROR: couldn't write benchmark results to " << resultsPath << std::endl;
+		return false;
+	}
+	file.precision(9);
+
+	file << "{\n";
+	file << "\t\"config\": { "
+		<< "\"physicsHz\": " << 1.0 / fixedDeltaTime << ", "
+		<< "\"matchSeconds\": " << matchSeconds << ", "
+		<< "\"seed\": " << BENCHMARK_SEED << ", "
+		<< "\"nbJobWorkers\": " << _broker->getJobSystem()->getNbWorkers() << ", "
+		<< "\"nbCarts\": " << _broker->getPhysicsManager()->_nbVehicles << ", "
+		<< "\"warmRestart\": " << (_broker->_warmRestart ? "true" : "false") << ", "
+		<< "\"allocationCounter\": " << (AllocationCounter::isEnabled() ? "true" : "false") << " },\n";
+	file << "\t\"scenarios\": [\n";
+	for (size_t i = 0; i < _scenarioResults.size(); i++) {
+		ScenarioResults &scenarioResults = _scenarioResults.at(i);
+		BenchmarkResults &results = scenarioResults._results;
+		file << "\t\t{\n";
+		file << "\t\t\t\"name\": \"" << getScenarioName(scenarioResults._scenario) << "\",\n";
+		file << "\t\t\t\"steps\": " << scenarioResults._nbSteps << ",\n";
+		file << "\t\t\t\"wallSeconds\": " << scenarioResults._wallSeconds << ",\n";
+		file << "\t\t\t\"stepsPerSecond\": " << (scenarioResults._wallSeconds > 0.0 ? scenarioResults._nbSteps / scenarioResults._wallSeconds : 0.0) << ",\n";
+		writeSamplesJson(file, "physicsUpdateMillis", results._physicsUpdateMillis, false);
+		writeSamplesJson(file, "simulateMillis", results._simulateMillis, false);
+		writeSamplesJson(file, "fetchResultsMillis", results._fetchResultsMillis, false);
+		writeSamplesJson(file, "aiUpdateMillis", results._aiUpdateMillis, false);
+		writeSamplesJson(file, "aiRaycastBatchMillis", results._aiRaycastBatchMillis, false);
+		writeSamplesJson(file, "aiRaysPerStep", results._aiRaysPerStep, false);
+		writeSamplesJson(file, "entityCleanupMillis", results._entityCleanupMillis, false);
+		writeSamplesJson(file, "allocationsPerStep", results._allocationsPerStep, false);
+		PickupPoolStats &poolStats = scenarioResults._pickupPoolStats;
+		file << "\t\t\t\"pickupPool\": { "
+			<< "\"size\": " << poolStats._nbCreated << ", "
+			<< "\"peakActive\": " << poolStats._peakActive << ", "
+			<< "\"hits\": " << poolStats._nbHits << ", "
+			<< "\"misses\": " << poolStats._nbMisses << ", "
+			<< "\"hitRate\": " << poolStats.getHitRate() << " }\n";
+		file << "\t\t}" << (i + 1 < _scenarioResults.size() ? "," : "") << "\n";
+	}
+	file << "\t]\n";
+	file << "}\n";
+
+	std::cout << "BENCHMARK: results written to " << resultsPath << std::endl;
+	return true;
+}
+
+
+bool Benchmark::writeScalingJson(const std::string &resultsPath, double fixedDeltaTime) {
+	std::ofstream file(resultsPath, std::ios::trunc);
+	if (!file) {
+		std::cout << "ERROR: couldn't write thread scaling results to " << resultsPath << std::endl;
+		return false;
+	}
+	file.precision(9);
+
+	file << "{\n";
+	file << "\t\"config\": { "
+		<< "\"physicsHz\": " << 1.0 / fixedDeltaTime << ", "
+		<< "\"nbHardwareThreads\": " << std::thread::hardware_concurrency() << ", "
+		<< "\"nbPlayers\": " << _broker->getInputReplay()->getNbPlayers() << ", "
+		<< "\"nbCarts\": " << _broker->getPhysicsManager()->_nbVehicles << " },\n";
+	file << "\t\"runs\": [\n";
+	for (size_t i = 0; i < _scalingResults.size(); i++) {
+		ScalingResults &scalingResults = _scalingResults.at(i);
+		BenchmarkResults &results = scalingResults._results;
+		file << "\t\t{\n";
+		file << "\t\t\t\"nbWorkers\": " << scalingResults._nbWorkers << ",\n";
+		file << "\t\t\t\"frames\": " << scalingResults._nbFrames << ",\n";
+		file << "\t\t\t\"wallSeconds\": " << scalingResults._wallSeconds << ",\n";
+		file << "\t\t\t\"desyncs\": " << scalingResults._nbDesyncs << ",\n";
+		writeSamplesJson(file, "simulateMillis", results._simulateMillis, false);
+		writeSamplesJson(file, "fetchResultsMillis", results._fetchResultsMillis, false);
+		writeSamplesJson(file, "physicsUpdateMillis", results._physicsUpdateMillis, true);
+		file << "\t\t}" << (i + 1 < _scalingResults.size() ? "," : "") << "\n";
+	}
+	file << "\t]\n";
+	file << "}\n";
+
+	std::cout << "THREAD SCALING: results written to " << resultsPath << std::endl;
+	return true;
+}
+
+
+const char* Benchmark::getScenarioName(BenchmarkScenarios scenario) {
+	switch (scenario) {
+		case BenchmarkScenarios::NORMAL_PLAY: return "normal_play";
+		case BenchmarkScenarios::COIN_STORM: return "coin_storm";
+		case BenchmarkScenarios::HOT_POTATO_CHASE: return "hot_potato_chase";
+		default: return "unknown";
+	}
+}
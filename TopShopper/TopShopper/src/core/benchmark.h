@@ -0,0 +1,126 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include "physics/pickuppool.h"
+
+
+class Broker;
+
+
+// DEFINITION:
+// HEADLESS MATCH BENCHMARK (run with --benchmark <results.json> [--bench-seconds N])
+// boots without a window, loads scene 1 with every cart (6 unless --carts) driven by the bot AI (autopilot), and plays a fixed length match per scenario:
+//		NORMAL_PLAY			- plain match
+//		COIN_STORM			- every cart explodes into spare change every couple of seconds (lots of spawns/destroys/contacts)
+//		HOT_POTATO_CHASE	- there's always a hot potato in play, so the carts keep chasing and bashing each other
+// every scenario starts from the same seed and the same kind of load (all cold loads, or all warm restarts of 1 parked scene with --warm-restart), and the results (mean/p50/p95/p99/max per phase + heap allocations per step + pickup pool hit rate) get written as JSON
+// so 2 builds can be diffed.
+//
+// THREAD SCALING (run with --replay <file> --thread-scaling <results.json>)
+// plays the same recorded match once per job system size in SCALING_WORKER_COUNTS (PhysX tasks run on the job system, see core/jobsystem.h),
+// cold loading every run, and writes simulate() / fetchResults() / total step time per worker count, so the real scaling curve can be read off.
+//
+// NOTE: pipelined physics is turned off while benchmarking, otherwise the step would be split across frames and couldn't be timed as 1 phase
+
+
+enum BenchmarkScenarios {
+	NORMAL_PLAY,
+	COIN_STORM,
+	HOT_POTATO_CHASE,
+	NUMBER_OF_BENCHMARK_SCENARIOS
+};
+
+
+struct BenchmarkSamples {
+	void add(double value) { _values.push_back(value); }
+	void clear() { _values.clear(); }
+
+	double getMean();
+	double getPercentile(double percentile); // nearest rank, percentile in [0,100]
+	double getMax();
+
+	std::vector<double> _values;
+};
+
+
+// filled in by the broker's match loop while a benchmark scenario is running (Broker::_benchmarkResults)...
+struct BenchmarkResults {
+	BenchmarkSamples _physicsUpdateMillis; // PhysicsManager::updateSeconds()
+	BenchmarkSamples _simulateMillis; // PxScene::simulate() (with 0 workers the whole step runs inside it)
+	BenchmarkSamples _fetchResultsMillis; // PxScene::fetchResults(true) (waiting on the workers)
+	BenchmarkSamples _aiUpdateMillis; // AIManager::updateSeconds()
+	BenchmarkSamples _aiRaycastBatchMillis; // executing every bot's navigation rays (1 PxBatchQuery)
+	BenchmarkSamples _aiRaysPerStep; // rays in that batch
+	BenchmarkSamples _entityCleanupMillis; // Broker::cleanupDestroyedEntities() (every frame, most have nothing to destroy)
+	BenchmarkSamples _allocationsPerStep; // filled in by the benchmark itself (1 step per frame, empty without ALLOCATION_COUNTER_ENABLED, i.e. outside the Profile build)
+};
+
+
+// times a block into a sample list (does nothing if samples is nullptr)...
+class BenchmarkTimer {
+public:
+	BenchmarkTimer(BenchmarkSamples *samples) : _samples(samples) {
+		if (_samples != nullptr) _start = std::chrono::steady_clock::now();
+	}
+	~BenchmarkTimer() {
+		if (_samples != nullptr) _samples->add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count());
+	}
+
+private:
+	BenchmarkSamples *_samples;
+	std::chrono::steady_clock::time_point _start;
+};
+
+
+
+class Benchmark {
+public:
+	Benchmark(Broker *broker) : _broker(broker) {}
+
+	int run(double fixedDeltaTime, double matchSeconds, const std::string &resultsPath); // returns the process exit code
+	int runThreadScaling(double fixedDeltaTime, const std::string &resultsPath); // needs a loaded replay, returns the process exit code
+
+	static const unsigned int BENCHMARK_SEED = 1234; // same workload every run
+
+private:
+	struct ScenarioResults {
+		BenchmarkScenarios _scenario;
+		BenchmarkResults _results;
+		unsigned long long _nbSteps = 0;
+		double _wallSeconds = 0.0;
+		PickupPoolStats _pickupPoolStats; // all pooled types combined
+	};
+
+	struct ScalingResults {
+		unsigned int _nbWorkers = 0;
+		BenchmarkResults _results;
+		unsigned long long _nbFrames = 0;
+		double _wallSeconds = 0.0;
+		unsigned long long _nbDesyncs = 0;
+	};
+
+	void runScenario(BenchmarkScenarios scenario, double fixedDeltaTime, double matchSeconds, ScenarioResults &out);
+	void runReplay(unsigned int nbWorkers, double fixedDeltaTime, ScalingResults &out);
+	void updateScenario(BenchmarkScenarios scenario, double simTime); // injects the scenario's events before each frame
+	bool writeJson(const std::string &resultsPath, double fixedDeltaTime, double matchSeconds);
+	bool writeScalingJson(const std::string &resultsPath, double fixedDeltaTime);
+
+	static const char* getScenarioName(BenchmarkScenarios scenario);
+
+	Broker *_broker = nullptr;
+	std::vector<ScenarioResults> _scenarioResults;
+	std::vector<ScalingResults> _scalingResults;
+
+	double _nextCoinStormTime = 0.0;
+	const double COIN_STORM_INTERVAL = 2.0; // seconds between explosions
+	const double HOT_POTATO_DURATION = 15.0; // same as a mystery bag hot potato
+
+	const unsigned int SCALING_WORKER_COUNTS[5] = { 0, 1, 2, 4, 8 }; // 0 = PhysX tasks run inline inside simulate()
+};
+
+
+
+#endif // BENCHMARK_H_
@@ -1,5 +1,11 @@
 #include "broker.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include "utility/profiler.h"
+#include "core/snapshot.h"
+#include "core/benchmark.h"
 
 // init statics:
 Broker* Broker::_instance = nullptr; // singleton instance starts out null
@@ -13,6 +19,8 @@ Broker* Broker::getInstance() {
 }
 
 Broker::Broker() {
+	_jobSystem = new JobSystem(JobSystem::getDefaultWorkerCount());
+	_inputReplay = new InputReplay();
 	_aiManager = new AIManager(this);
 	_audioManager = new AudioManager(this);
 	_inputManager = new InputManager(this);
@@ -41,47 +49,194 @@ void Broker::initAll() {
 
 
 void Broker::updateAllSeconds(double& simTime, const double& fixedDeltaTime, double& variableDeltaTime, double& accumulator) {
-	
+	PROFILE_SCOPE("Broker::updateAllSeconds");
+
+	// PIPELINED PHYSICS: finish the step that was simulating while last frame rendered (must happen before anything can touch/release the scene)...
+	if (_physicsManager->isStepInFlight()) {
+		_physicsManager->endStep();
+		cleanupDestroyedEntities();
+	}
+
 	_loadingManager->updateSeconds(variableDeltaTime); // useless right now, but if we want dynamic loading it could go first
 	_inputManager->updateSeconds(variableDeltaTime); // NOTE: this needs to be done before physics updates
-	
-	manageScene(accumulator, variableDeltaTime);
+
+	// DUMP PROFILER TRACE ON DEMAND...
+	if (_inputManager->getKeyboardAndMouse()->f9KeyJustPressed && Profiler::isEnabled()) {
+		Profiler::dumpChromeTrace("profile.json");
+	}
+
+	// PVD CAPTURE ON DEMAND (bounded by --pvd-frames)...
+	if (_inputManager->getKeyboardAndMouse()->f10KeyJustPressed) {
+		_physicsManager->getPvdCapture()->toggleCapture();
+	}
+
+	{
+		PROFILE_SCOPE("Broker::manageScene");
+		manageScene(accumulator, variableDeltaTime);
+	}
 	//std::cout << std::to_string(_scene) << std::endl;
 
+	bool startDeferredStep = false;
 	if (_scene == GAME) {
-		while (accumulator >= fixedDeltaTime) {
-			_physicsManager->updateSeconds(fixedDeltaTime);
+		_inputReplay->recordFrame(fixedDeltaTime, variableDeltaTime, accumulator);
+
+		int nbSubsteps = 0;
+		while (accumulator >= fixedDeltaTime && nbSubsteps < MAX_PHYSICS_SUBSTEPS_PER_FRAME) {
 			accumulator -= fixedDeltaTime;
 			simTime += fixedDeltaTime;
+			nbSubsteps++;
+
+			// in pipelined mode the last step of the frame gets started after AI and left running during rendering
+			bool isLastStep = accumulator < fixedDeltaTime || nbSubsteps == MAX_PHYSICS_SUBSTEPS_PER_FRAME;
+			if (_physicsManager->_pipelined && isLastStep) {
+				startDeferredStep = true;
+			}
+			else {
+				BenchmarkTimer timer(_benchmarkResults != nullptr ? &_benchmarkResults->_physicsUpdateMillis : nullptr);
+				_physicsManager->updateSeconds(fixedDeltaTime);
+			}
 		}
-		
-		_aiManager->updateSeconds(variableDeltaTime);
+
+		// TIME DILATION: if we fell too far behind, throw away the whole steps we couldn't afford (keeping the partial one for interpolation)...
+		// the rest of the frame then uses the dilated delta time so game timers stay in sync with the simulation
+		double dilatedDeltaTime = variableDeltaTime;
+		if (accumulator >= fixedDeltaTime) {
+			double droppedTime = floor(accumulator / fixedDeltaTime) * fixedDeltaTime;
+			accumulator -= droppedTime;
+			dilatedDeltaTime = std::max(0.0, variableDeltaTime - droppedTime);
+		}
+		_interpolationAlpha = accumulator / fixedDeltaTime;
+
+		BenchmarkTimer timer(_benchmarkResults != nullptr ? &_benchmarkResults->_aiUpdateMillis : nullptr);
+		_aiManager->updateSeconds(dilatedDeltaTime);
+	}
+
+	if (startDeferredStep) {
+		_physicsManager->beginStep(fixedDeltaTime);
+	}
+
+	if (_scene == END_SCREEN) {
+		_inputReplay->endMatch(); // only does anything the first time
 	}
-	
 
 	_renderingManager->updateSeconds(variableDeltaTime);
 	_audioManager->updateSeconds(variableDeltaTime); // NOTE: probably need to guard this to either only play in GAME scene or stop audio once left GAME scene??
-	
 
+	// NOTE: if a step is still simulating, this gets done right after it's fetched next frame instead
+	if (!_physicsManager->isStepInFlight()) {
+		cleanupDestroyedEntities();
+	}
+
+}
+
+
+void Broker::cleanupDestroyedEntities() {
 	if (_scene == GAME || _scene == PAUSED || _scene == END_SCREEN) {
-		// CLEANUP ENTITIES FLAGGED TO BE DESTROYED...
-		std::vector<std::shared_ptr<Entity>> destroyedEntities;
-		for (std::shared_ptr<Entity> &entity : _physicsManager->getActiveScene()->_entities) {
-			if (entity->getDestroyFlag()) {
-				destroyedEntities.push_back(entity);
-			}
-		}
+		std::shared_ptr<GameScene> scene = _physicsManager->getActiveScene();
+		BenchmarkTimer timer(_benchmarkResults != nullptr ? &_benchmarkResults->_entityCleanupMillis : nullptr); // NOTE: every frame, so the percentiles include the frames with nothing to do
+		if (!scene->hasQueuedDestroys()) return; // nothing was destroyed this frame
+
+		PROFILE_SCOPE("Broker::entityCleanup");
+		// CLEANUP ENTITIES FLAGGED TO BE DESTROYED (loop since onDestroy() could destroy more entities)...
+		std::vector<EntityHandle> destroyQueue;
+		while (scene->hasQueuedDestroys()) {
+			scene->takeDestroyQueue(destroyQueue);
+			for (EntityHandle &handle : destroyQueue) {
+				std::shared_ptr<Entity> entity = scene->getEntity(handle);
+				if (entity == nullptr) continue; // already gone
 
-		for (std::shared_ptr<Entity> &entity : destroyedEntities) {
-			std::shared_ptr<Component> comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (comp != nullptr) {
-				std::shared_ptr<BehaviourScript> script = std::static_pointer_cast<BehaviourScript>(comp);
-				script->onDestroy();
+				Component *comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
+				if (comp != nullptr) {
+					BehaviourScript *script = static_cast<BehaviourScript*>(comp);
+					script->onDestroy();
+				}
+				scene->removeEntity(entity);
 			}
-			_physicsManager->getActiveScene()->removeEntity(entity);
 		}
 	}
+}
+
+
+void Broker::startHeadlessMatch() {
+	_nbPlayers = _inputReplay->isPlaying() ? _inputReplay->getNbPlayers() : 1; // player 1 stays HUMAN (with no input unless replaying) since scripts use them as the listener/reference cart
+	loadMatch();
+	_scene = GAME;
+}
+
+
+void Broker::loadMatch() {
+	PROFILE_SCOPE("Broker::loadMatch");
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	bool isWarm = _warmRestart && _physicsManager->hasActiveScene();
+	_inputReplay->beginMatch(_nbPlayers, _physicsManager->_nbVehicles, _physicsManager->_pipelined, isWarm); // reseeds rand() when recording/replaying, so it has to go before the spawn shuffle
+	// NOTE: keep it in this order...
+	if (isWarm) {
+		_physicsManager->restartScene1(_nbPlayers);
+		_aiManager->cleanupScene1(); // resets all the spawn/match state (nothing in there holds onto PhysX objects)
+	}
+	else {
+		_physicsManager->loadScene1(_nbPlayers);
+	}
+	_aiManager->loadScene1();
+	_renderingManager->loadScene1();
+
+	_lastMatchLoadMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "MATCH LOAD: " << (isWarm ? "warm restart" : "cold load") << " took " << _lastMatchLoadMillis << "ms" << std::endl;
+}
+
+
+void Broker::leaveMatch() {
+	_inputReplay->endMatch(); // quitting early still leaves a valid (shorter) recording
+
+	if (_warmRestart) return; // scene stays parked until the next loadMatch()
 
+	// NOTE: keep in this order...
+	_physicsManager->cleanupScene1();
+	_aiManager->cleanupScene1();
+}
+
+
+bool Broker::captureSnapshot(std::vector<uint8_t> &blob) {
+	PROFILE_SCOPE("Broker::captureSnapshot");
+	if (!_physicsManager->hasActiveScene()) return false;
+
+	_physicsManager->endStep(); // a step still in flight dispatches its collision callbacks here, which can flag more entities...
+	cleanupDestroyedEntities(); // ...and flagged entities would be gone by the end of the frame anyway
+
+	SnapshotWriter writer(blob);
+	writer.write((uint32_t)SNAPSHOT_MAGIC);
+	writer.write((uint32_t)SNAPSHOT_VERSION);
+
+	// NOTE: keep in this order (AI instances are resolved through the physics section)...
+	_physicsManager->writeSnapshot(writer);
+	_aiManager->writeSnapshot(writer);
+	return true;
+}
+
+
+bool Broker::restoreSnapshot(const std::vector<uint8_t> &blob) {
+	PROFILE_SCOPE("Broker::restoreSnapshot");
+	if (!_physicsManager->hasActiveScene()) return false;
+
+	SnapshotReader reader(blob);
+	uint32_t magic = 0, version = 0;
+	reader.read(magic);
+	reader.read(version);
+	if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		std::cout << "ERROR: not a snapshot from this build (magic " << magic << ", version " << version << ")" << std::endl;
+		return false;
+	}
+
+	_physicsManager->endStep(); // same as captureSnapshot(), the in-flight step's callbacks can still flag entities
+	cleanupDestroyedEntities();
+
+	// NOTE: keep in this order...
+	if (!_physicsManager->readSnapshot(reader) || !_aiManager->readSnapshot(reader) || !reader.isAtEnd()) {
+		std::cout << "ERROR: snapshot is truncated or doesn't match the current scene" << std::endl;
+		return false;
+	}
+	return true;
 }
 
 
@@ -206,10 +361,7 @@ void Broker::manageScene(double& accumulator, double vartime) {
 			delayX = 0.0;
 
 			// NOTE: this is where we need to reset the PhysX and AI (should probably display the loading screen image first before calling reset functions)
-			// NOTE: keep it in this order...
-			_physicsManager->loadScene1(_nbPlayers);
-			_aiManager->loadScene1();
-			_renderingManager->loadScene1();
+			loadMatch();
 		}
 		if ((kam->spaceKeyJustPressed || (playerControlled && player1->bButtonJustPressed))) {
 			_scene = MAIN_MENU;
@@ -269,9 +421,7 @@ void Broker::manageScene(double& accumulator, double vartime) {
 				_scene = MAIN_MENU;
 				_cursorPositionPause = 1;
 				_audioManager->playSFX(_audioManager->getSoundEffect(SoundEffectTypes::SELECT_SOUND));
-				// NOTE: keep in this order...
-				_physicsManager->cleanupScene1();
-				_aiManager->cleanupScene1();
+				leaveMatch();
 			}
 			delayX = 0.0;
 		}
@@ -298,9 +448,7 @@ void Broker::manageScene(double& accumulator, double vartime) {
 			delayX = 0.0;
 			_audioManager->playSFX(_audioManager->getSoundEffect(SoundEffectTypes::SELECT_SOUND));
 
-			// NOTE: keep in this order...
-			_physicsManager->cleanupScene1();
-			_aiManager->cleanupScene1();
+			leaveMatch();
 			_audioManager->resetAudio();
 		}
 		break;
@@ -7,7 +7,12 @@
 #include "loading/loadingmanager.h"
 #include "physics/physicsmanager.h"
 #include "rendering/renderingmanager.h"
+#include "core/jobsystem.h"
+#include "core/inputreplay.h"
 
+struct BenchmarkResults;
+
+#define MAX_PHYSICS_SUBSTEPS_PER_FRAME 5 // spiral of death protection: after this many fixed steps in 1 frame, the leftover time gets dropped (game slows down instead)
 
 
 enum Scenes {
@@ -30,6 +35,16 @@ public:
 	void initAll(); // calls each subsystem's init function
 	void updateAllSeconds(double& simTime, const double& fixedDeltaTime, double& variableDeltaTime, double& accumulator); // this update function will call each subsystem's update function in an appropriate order.
 	void manageScene(double& accumulator, double vartime);
+	void cleanupDestroyedEntities(); // removes every entity flagged with destroy() from the active scene
+	void startHeadlessMatch(); // skips the menus and loads straight into a GAME scene (headless mode only)
+	void loadMatch(); // warm restarts the parked scene if there is one, otherwise does a full (cold) load, and reports how long it took
+	void leaveMatch(); // back to the menus: parks the scene for a warm restart, or tears it down if warm restarts are off
+
+	// GAME-STATE SNAPSHOTS (see core/snapshot.h)...
+	// captures/restores the whole match (bodies, vehicles, players, AI spawners) to/from a flat blob, restoring reuses the existing actors in place
+	// NOTE: call between frames (not from inside a script callback), both return false if there's no match loaded or the blob is invalid
+	bool captureSnapshot(std::vector<uint8_t> &blob);
+	bool restoreSnapshot(const std::vector<uint8_t> &blob);
 
 	AIManager* getAIManager() { return _aiManager; }
 	AudioManager* getAudioManager() { return _audioManager; }
@@ -37,6 +52,8 @@ public:
 	LoadingManager* getLoadingManager() { return _loadingManager; }
 	PhysicsManager* getPhysicsManager() { return _physicsManager; }
 	RenderingManager* getRenderingManager() { return _renderingManager; }
+	JobSystem* getJobSystem() { return _jobSystem; }
+	InputReplay* getInputReplay() { return _inputReplay; }
 
 	Scenes _scene;
 	unsigned int _cursorPositionStart;
@@ -46,6 +63,12 @@ public:
 	int _nbPlayers;
 	int _nbOfDevices; // e.g. 1 keyboard if 0 controllers plugged in. 1 controller, 0 keyboard if 1 controller plugged in
 	double _gameStartTimer = 3.0; // 3 sec
+	double _interpolationAlpha = 1.0; // how far (0-1) real time is between the last 2 physics steps, used by rendering to blend poses
+	bool _headless = false; // if true, rendering/audio/input become null backends (no window, no SDL) and main() drives the sim with a synthetic clock
+	bool _warmRestart = true; // keep the PxScene + static geometry alive between matches (--cold-restart turns this off)
+	double _lastMatchLoadMillis = 0.0; // how long the last loadMatch() took
+	bool _autopilot = false; // if true, human carts are driven by the bot AI too (benchmarks)
+	BenchmarkResults *_benchmarkResults = nullptr; // if set, the match loop records its phase timings into this (see core/benchmark.h)
 
 private:
 	static Broker* _instance;
@@ -57,6 +80,8 @@ private:
 	LoadingManager * _loadingManager = nullptr;
 	PhysicsManager *_physicsManager = nullptr;
 	RenderingManager *_renderingManager = nullptr;
+	JobSystem *_jobSystem = nullptr; // shared thread pool (also runs PhysX tasks)
+	InputReplay *_inputReplay = nullptr; // match recording (--record) / playback (--replay)
 	Gamepad* player1 = nullptr;
 };
 
@@ -0,0 +1,138 @@
+#include "componentpools.h"
+#include "objects/entity.h"
+#include "objects/shoppingcartplayer.h"
+#include "vehicle/vehicleshoppingcart.h"
+
+using namespace physx;
+
+
+
+void ComponentPools::add(Entity *entity) {
+	// BEHAVIOUR SCRIPTS...
+	Component *comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
+	if (comp == nullptr) return; // nothing pooled for entities without a script (e.g. environment)
+	BehaviourScript *script = static_cast<BehaviourScript*>(comp);
+
+	setSparse(_scriptSparse, entity->_handle, (uint32_t)_scripts._owners.size());
+	_scripts._owners.push_back(entity->_handle);
+	_scripts._scripts.push_back(script);
+
+	// FIXED UPDATES...
+	if (script->_fixedUpdateMode != FixedUpdateModes::FIXED_UPDATE_NEVER) {
+		addToSet(_fixedUpdates, _fixedUpdateSparse, entity->_handle, script);
+	}
+
+	// FRAME UPDATES (only the scripts that asked for them)...
+	if (script->_frameCallbacks & FrameCallbacks::FRAME_CALLBACK_UPDATE) addToSet(_updates, _updateSparse, entity->_handle, script);
+	if (script->_frameCallbacks & FrameCallbacks::FRAME_CALLBACK_LATE_UPDATE) addToSet(_lateUpdates, _lateUpdateSparse, entity->_handle, script);
+
+	// PLAYERS...
+	if (comp->_tag == ComponentTypes::PLAYER_SCRIPT) {
+		setSparse(_playerSparse, entity->_handle, (uint32_t)_players._owners.size());
+		_players._owners.push_back(entity->_handle);
+		_players._scripts.push_back(static_cast<PlayerScript*>(comp));
+		_players._vehicles.push_back(entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER ? static_cast<ShoppingCartPlayer*>(entity)->_shoppingCartBase->_vehicle4W : nullptr);
+		_players._points.push_back(0);
+		_players._shoppingListTypes.push_back({ EntityTypes::NONE, EntityTypes::NONE, EntityTypes::NONE }); // filled in by onSpawn()
+		_players._shoppingListFlags.push_back({ false, false, false });
+		_players._hasHotPotato.push_back(false);
+		_players._hotPotatoTimers.push_back(-1.0);
+	}
+	// PICKUPS...
+	else if (comp->_tag == ComponentTypes::PICKUP_SCRIPT) {
+		PickupScript *pickupScript = static_cast<PickupScript*>(comp);
+		setSparse(_pickupSparse, entity->_handle, (uint32_t)_pickups._owners.size());
+		_pickups._owners.push_back(entity->_handle);
+		_pickups._scripts.push_back(pickupScript);
+		_pickups._points.push_back(pickupScript->_points);
+		_pickups._isSolid.push_back(false); // spawned/reacquired as a trigger
+	}
+}
+
+
+void ComponentPools::remove(Entity *entity) {
+	uint32_t scriptIndex = getScriptIndex(entity->_handle);
+	if (scriptIndex == INVALID_POOL_INDEX) return;
+
+	// BEHAVIOUR SCRIPTS (swap and pop)...
+	uint32_t lastIndex = (uint32_t)_scripts._owners.size() - 1;
+	if (scriptIndex != lastIndex) {
+		_scripts._owners[scriptIndex] = _scripts._owners[lastIndex];
+		_scripts._scripts[scriptIndex] = _scripts._scripts[lastIndex];
+		setSparse(_scriptSparse, _scripts._owners[scriptIndex], scriptIndex);
+	}
+	_scripts._owners.pop_back();
+	_scripts._scripts.pop_back();
+	setSparse(_scriptSparse, entity->_handle, INVALID_POOL_INDEX);
+
+	removeFromSet(_fixedUpdates, _fixedUpdateSparse, entity->_handle);
+	removeFromSet(_updates, _updateSparse, entity->_handle);
+	removeFromSet(_lateUpdates, _lateUpdateSparse, entity->_handle);
+
+	// PLAYERS (ordered erase, so the rows stay in the same order as the cart registry, there's only a handful of them anyway)...
+	uint32_t playerIndex = getPlayerIndex(entity->_handle);
+	if (playerIndex != INVALID_POOL_INDEX) {
+		_players._owners.erase(_players._owners.begin() + playerIndex);
+		_players._scripts.erase(_players._scripts.begin() + playerIndex);
+		_players._vehicles.erase(_players._vehicles.begin() + playerIndex);
+		_players._points.erase(_players._points.begin() + playerIndex);
+		_players._shoppingListTypes.erase(_players._shoppingListTypes.begin() + playerIndex);
+		_players._shoppingListFlags.erase(_players._shoppingListFlags.begin() + playerIndex);
+		_players._hasHotPotato.erase(_players._hasHotPotato.begin() + playerIndex);
+		_players._hotPotatoTimers.erase(_players._hotPotatoTimers.begin() + playerIndex);
+		for (uint32_t i = playerIndex; i < _players._owners.size(); i++) {
+			setSparse(_playerSparse, _players._owners[i], i);
+		}
+		setSparse(_playerSparse, entity->_handle, INVALID_POOL_INDEX);
+	}
+
+	// PICKUPS (swap and pop)...
+	uint32_t pickupIndex = getPickupIndex(entity->_handle);
+	if (pickupIndex != INVALID_POOL_INDEX) {
+		uint32_t lastPickupIndex = (uint32_t)_pickups._owners.size() - 1;
+		if (pickupIndex != lastPickupIndex) {
+			_pickups._owners[pickupIndex] = _pickups._owners[lastPickupIndex];
+			_pickups._scripts[pickupIndex] = _pickups._scripts[lastPickupIndex];
+			_pickups._points[pickupIndex] = _pickups._points[lastPickupIndex];
+			_pickups._isSolid[pickupIndex] = _pickups._isSolid[lastPickupIndex];
+			setSparse(_pickupSparse, _pickups._owners[pickupIndex], pickupIndex);
+		}
+		_pickups._owners.pop_back();
+		_pickups._scripts.pop_back();
+		_pickups._points.pop_back();
+		_pickups._isSolid.pop_back();
+		setSparse(_pickupSparse, entity->_handle, INVALID_POOL_INDEX);
+	}
+}
+
+
+void ComponentPools::addToSet(ScriptSet &set, std::vector<uint32_t> &sparse, EntityHandle handle, BehaviourScript *script) {
+	if (lookup(sparse, set._owners, handle) != INVALID_POOL_INDEX) return; // already in there
+
+	setSparse(sparse, handle, (uint32_t)set._owners.size());
+	set._owners.push_back(handle);
+	set._scripts.push_back(script);
+}
+
+
+void ComponentPools::removeFromSet(ScriptSet &set, std::vector<uint32_t> &sparse, EntityHandle handle) {
+	uint32_t index = lookup(sparse, set._owners, handle);
+	if (index == INVALID_POOL_INDEX) return;
+
+	// swap and pop...
+	uint32_t lastIndex = (uint32_t)set._owners.size() - 1;
+	if (index != lastIndex) {
+		set._owners[index] = set._owners[lastIndex];
+		set._scripts[index] = set._scripts[lastIndex];
+		setSparse(sparse, set._owners[index], index);
+	}
+	set._owners.pop_back();
+	set._scripts.pop_back();
+	setSparse(sparse, handle, INVALID_POOL_INDEX);
+}
+
+
+void ComponentPools::setSparse(std::vector<uint32_t> &sparse, EntityHandle handle, uint32_t denseIndex) {
+	if (handle._slot >= sparse.size()) sparse.resize(handle._slot + 1, INVALID_POOL_INDEX);
+	sparse[handle._slot] = denseIndex;
+}
@@ -0,0 +1,116 @@
+#ifndef COMPONENTPOOLS_H_
+#define COMPONENTPOOLS_H_
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "core/gamescene.h"
+
+
+class Entity;
+struct BehaviourScript;
+struct PlayerScript;
+struct PickupScript;
+enum EntityTypes;
+
+namespace physx {
+	class PxVehicleWheels;
+};
+
+
+// DEFINITION:
+// DENSE STRUCTURE-OF-ARRAYS COMPONENT STORAGE (1 per GameScene, filled/emptied by addEntity()/removeEntity())
+// the hot per-entity gameplay state lives here in parallel arrays instead of inside each heap-allocated script,
+// so the per-frame loops walk contiguous memory instead of copying shared_ptrs (atomic refcounts) and chasing pointers per entity.
+// - each pool is a sparse set: handle slot -> dense index (O(1) lookup/add/remove), dense index -> owner handle
+// - scripts are still the behaviour API (virtual callbacks), they just read/write their state through their pool row (e.g. PlayerScript::points())
+//
+// POOLS:
+//		_scripts - every BehaviourScript
+//		_fixedUpdates - the scripts that get fixedUpdate() every step (FIXED_UPDATE_ALWAYS ones)
+//		_updates / _lateUpdates - the scripts that asked for update() / lateUpdate() (see FrameCallbacks), the AI/rendering loops only walk these
+//								  so they don't pay a virtual call per script for the empty ones
+//		_players - PlayerScript state + vehicle handle, in cart spawn order (same order as GameScene::getAllShoppingCartPlayers())
+//		_pickups - PickupScript rows (points are copied in from the prefab on add)
+//
+// NOTE: rows only exist while the entity is in a scene, so don't touch pooled state before addEntity() or after removeEntity()
+// NOTE: lookups check the handle's generation too, so a stale handle (its slot since reused by another entity) comes back as INVALID_POOL_INDEX
+// NOTE: the fixed/AI/late loops may spawn entities (push_back), so iterate by index up to the size at the start of the loop and re-read the array each iteration
+
+
+static const uint32_t INVALID_POOL_INDEX = UINT32_MAX;
+
+
+struct ScriptPool {
+	std::vector<EntityHandle> _owners;
+	std::vector<BehaviourScript*> _scripts; // NOTE: raw pointers, the owning entity keeps the script alive for as long as the row exists
+};
+
+
+struct ScriptSet { // a subset of the scripts that 1 loop ticks (unordered, swap and pop)
+	std::vector<EntityHandle> _owners;
+	std::vector<BehaviourScript*> _scripts;
+};
+
+
+struct PlayerPool {
+	std::vector<EntityHandle> _owners;
+	std::vector<PlayerScript*> _scripts;
+	std::vector<physx::PxVehicleWheels*> _vehicles; // can be handed straight to PxVehicleSuspensionRaycasts() / PxVehicleUpdates()
+
+	std::vector<int> _points;
+	std::vector<std::array<EntityTypes, 3>> _shoppingListTypes; // e.g. MILK, APPLE, CARROT
+	std::vector<std::array<bool, 3>> _shoppingListFlags; // e.g. MILK=false, APPLE=true, CARROT=true
+	std::vector<uint8_t> _hasHotPotato; // NOTE: not vector<bool>, since that packs bits and turns every write into a read-modify-write
+	std::vector<double> _hotPotatoTimers; // -1 when not holding the hot potato
+};
+
+
+struct PickupPool {
+	std::vector<EntityHandle> _owners;
+	std::vector<PickupScript*> _scripts;
+	std::vector<int> _points; // value of each pickup
+	std::vector<uint8_t> _isSolid; // knocked loose from a bashed cart (simulated rigid body), otherwise a resting kinematic trigger (see PhysicsManager::setPickupSolid())
+};
+
+
+
+class ComponentPools {
+	public:
+		void add(Entity *entity); // NOTE: entity must already have its handle
+		void remove(Entity *entity);
+
+		uint32_t getScriptIndex(EntityHandle handle) { return lookup(_scriptSparse, _scripts._owners, handle); }
+		uint32_t getPlayerIndex(EntityHandle handle) { return lookup(_playerSparse, _players._owners, handle); }
+		uint32_t getPickupIndex(EntityHandle handle) { return lookup(_pickupSparse, _pickups._owners, handle); }
+
+		ScriptPool _scripts;
+		ScriptSet _fixedUpdates;
+		ScriptSet _updates;
+		ScriptSet _lateUpdates;
+		PlayerPool _players;
+		PickupPool _pickups;
+
+	private:
+		uint32_t lookup(const std::vector<uint32_t> &sparse, const std::vector<EntityHandle> &owners, EntityHandle handle) {
+			uint32_t index = handle._slot < sparse.size() ? sparse[handle._slot] : INVALID_POOL_INDEX;
+			return (index != INVALID_POOL_INDEX && owners[index] == handle) ? index : INVALID_POOL_INDEX;
+		}
+		void setSparse(std::vector<uint32_t> &sparse, EntityHandle handle, uint32_t denseIndex);
+		void addToSet(ScriptSet &set, std::vector<uint32_t> &sparse, EntityHandle handle, BehaviourScript *script);
+		void removeFromSet(ScriptSet &set, std::vector<uint32_t> &sparse, EntityHandle handle);
+
+		// [handle slot] -> dense index (INVALID_POOL_INDEX if the entity in that slot isn't in the pool)
+		std::vector<uint32_t> _scriptSparse;
+		std::vector<uint32_t> _fixedUpdateSparse;
+		std::vector<uint32_t> _updateSparse;
+		std::vector<uint32_t> _lateUpdateSparse;
+		std::vector<uint32_t> _playerSparse;
+		std::vector<uint32_t> _pickupSparse;
+};
+
+
+
+
+
+#endif // COMPONENTPOOLS_H_
@@ -1,4 +1,7 @@
 #include "gamescene.h"
+#include "componentpools.h"
+#include "physics/pickuppool.h"
+#include "physics/pickupgrid.h"
 #include "PxScene.h"
 #include "objects/shoppingcartplayer.h"
 #include "objects/sparechange.h"
@@ -12,68 +15,120 @@ using namespace physx;
 GameScene::GameScene(PxScene *physxScene) 
 	: _physxScene(physxScene)
 {
-
+	_entitiesByType.resize(EntityTypes::NUMBER_OF_ENTITY_TYPES);
+	_componentPools = new ComponentPools();
 }
 
 GameScene::~GameScene() {
-
+	delete _componentPools;
+	_componentPools = nullptr;
 }
 
 
 void GameScene::addEntity(std::shared_ptr<Entity> entity) {
-	_entities.push_back(entity);
-	_physxScene->addActor(*(entity->_actor));
-}
+	// grab a slot (reuse a freed one if possible)...
+	uint32_t slot;
+	if (!_freeSlots.empty()) {
+		slot = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+	else {
+		slot = (uint32_t)_slots.size();
+		_slots.push_back(EntitySlot());
+	}
+	_slots.at(slot)._denseIndex = (uint32_t)_entities.size();
+	entity->_handle = EntityHandle(slot, _slots.at(slot)._generation);
+	entity->_scene = this;
 
+	_entities.push_back(entity);
 
-void GameScene::removeEntity(std::shared_ptr<Entity> entity) {
-	for (int i = 0; i < _entities.size(); i++) {
-		if (_entities.at(i) == entity) { // if both pointers point to same address...
-			_physxScene->removeActor(*(entity->_actor));
-			entity->_actor->is<PxRigidActor>()->release();
-			entity->_actor = nullptr;
-			if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
-				std::dynamic_pointer_cast<ShoppingCartPlayer>(entity)->_shoppingCartBase->_vehicle4W->free();
-			}
-			_entities.erase(_entities.begin() + i);
-			break;
-		}
+	// TYPED REGISTRIES (downcast once here instead of on every query)...
+	// NOTE: dynamic casting needs the complete type, so shoppingcartplayer.h / sparechange.h must stay included in this file
+	std::vector<std::shared_ptr<Entity>> &sameType = _entitiesByType.at(entity->getTag());
+	_slots.at(slot)._typeIndex = (uint32_t)sameType.size();
+	sameType.push_back(entity);
+	if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
+		_shoppingCartPlayers.push_back(std::dynamic_pointer_cast<ShoppingCartPlayer>(entity));
+	}
+	else if (entity->getTag() == EntityTypes::SPARE_CHANGE) {
+		_spareChange.push_back(std::dynamic_pointer_cast<SpareChange>(entity));
 	}
-}
 
+	_componentPools->add(entity.get());
 
+	if (entity->_actor->getScene() == nullptr) _physxScene->addActor(*(entity->_actor)); // pooled actors never leave the PxScene
+	entity->resetPoseHistory();
+}
 
 
+void GameScene::removeEntity(std::shared_ptr<Entity> entity) {
+	if (entity == nullptr || getEntity(entity->_handle) != entity) return; // not in this scene (or already removed)
 
+	EntitySlot &slot = _slots.at(entity->_handle._slot);
+	uint32_t index = slot._denseIndex;
 
+	if (_pickupGrid != nullptr) _pickupGrid->remove(entity.get()); // NOTE: keyed by the handle, so before it gets invalidated below
 
+	if (_pickupPool != nullptr && _pickupPool->isPooled(entity->getTag())) {
+		_pickupPool->recycle(entity); // keeps the actor (disabled) for the next spawn
+	}
+	else {
+		_physxScene->removeActor(*(entity->_actor));
+		entity->_actor->is<PxRigidActor>()->release();
+		entity->_actor = nullptr;
+	}
+	if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
+		std::dynamic_pointer_cast<ShoppingCartPlayer>(entity)->_shoppingCartBase->_vehicle4W->free();
+	}
 
-// ~~~~~~NOTE: about dynamic casting, you must have a complete type (e.g. bug was caused by forward declaring ShoppingCartPlayer in scene.h, but forgetting to include shoppingcartplayer.h in this file...)
-// ~~~~~~NOTE: could change this in future to be general (pass in tag enum and return proper vector) or instead cache a vector of every entity type
-std::vector<std::shared_ptr<ShoppingCartPlayer>> GameScene::getAllShoppingCartPlayers() {
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> shoppingCartPlayers; // empty vector
-	for (std::shared_ptr<Entity> &entity : _entities) {
-		if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
-			// downcast...
-			std::shared_ptr<ShoppingCartPlayer> shoppingCartPlayer = std::dynamic_pointer_cast<ShoppingCartPlayer>(entity);
-			shoppingCartPlayers.push_back(shoppingCartPlayer);
+	// SWAP AND POP: move the last entity into the hole, then fix up its slot...
+	uint32_t lastIndex = (uint32_t)_entities.size() - 1;
+	if (index != lastIndex) {
+		_entities.at(index) = _entities.at(lastIndex);
+		_slots.at(_entities.at(index)->_handle._slot)._denseIndex = index;
+	}
+	_entities.pop_back();
+
+	// TYPED REGISTRIES...
+	std::vector<std::shared_ptr<Entity>> &sameType = _entitiesByType.at(entity->getTag());
+	uint32_t typeIndex = slot._typeIndex;
+	if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
+		// carts keep their order since their index doubles as the player colour / viewport (and there's only a handful of them)
+		sameType.erase(sameType.begin() + typeIndex);
+		_shoppingCartPlayers.erase(_shoppingCartPlayers.begin() + typeIndex);
+		for (uint32_t i = typeIndex; i < sameType.size(); i++) {
+			_slots.at(sameType.at(i)->_handle._slot)._typeIndex = i;
 		}
 	}
+	else {
+		uint32_t lastTypeIndex = (uint32_t)sameType.size() - 1;
+		if (typeIndex != lastTypeIndex) {
+			sameType.at(typeIndex) = sameType.at(lastTypeIndex);
+			_slots.at(sameType.at(typeIndex)->_handle._slot)._typeIndex = typeIndex;
+			if (entity->getTag() == EntityTypes::SPARE_CHANGE) _spareChange.at(typeIndex) = _spareChange.at(lastTypeIndex);
+		}
+		sameType.pop_back();
+		if (entity->getTag() == EntityTypes::SPARE_CHANGE) _spareChange.pop_back();
+	}
+
+	_componentPools->remove(entity.get());
 
-	return shoppingCartPlayers;
+	// invalidate every outstanding handle to this entity...
+	slot._generation++;
+	_freeSlots.push_back(entity->_handle._slot);
+	entity->_handle = EntityHandle();
+	entity->_scene = nullptr;
 }
 
 
+std::shared_ptr<Entity> GameScene::getEntity(EntityHandle handle) {
+	if (handle._slot >= _slots.size()) return nullptr;
+	const EntitySlot &slot = _slots.at(handle._slot);
+	if (slot._generation != handle._generation) return nullptr;
+	return _entities.at(slot._denseIndex);
+}
 
-std::vector<std::shared_ptr<SpareChange>> GameScene::getAllSpareChange() {
-	std::vector<std::shared_ptr<SpareChange>> spareChangeVec; // empty vector
-	for (std::shared_ptr<Entity> &entity : _entities) {
-		if (entity->getTag() == EntityTypes::SPARE_CHANGE) {
-			// downcast...
-			std::shared_ptr<SpareChange> spareChange = std::dynamic_pointer_cast<SpareChange>(entity);
-			spareChangeVec.push_back(spareChange);
-		}
-	}
 
-	return spareChangeVec;
+const std::vector<std::shared_ptr<Entity>>& GameScene::getEntitiesOfType(EntityTypes type) {
+	return _entitiesByType.at(type);
 }
@@ -3,16 +3,36 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 class Entity;
 class ShoppingCartPlayer;
 class SpareChange;
+class ComponentPools;
+class PickupActorPool;
+class PickupGrid;
+enum EntityTypes;
 
 namespace physx {
 	class PxScene;
 };
 
 
+// GENERATIONAL HANDLE...
+// refers to an entity through a slot in the scene's slot table instead of a pointer
+// when the entity gets removed the slot's generation is bumped, so any old handle to it just resolves to nullptr (never to whatever reuses the slot)
+struct EntityHandle {
+	EntityHandle() {}
+	EntityHandle(uint32_t slot, uint32_t generation) : _slot(slot), _generation(generation) {}
+
+	bool operator==(const EntityHandle &other) const { return _slot == other._slot && _generation == other._generation; }
+	bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+
+	uint32_t _slot = UINT32_MAX; // UINT32_MAX = null handle
+	uint32_t _generation = 0;
+};
+
+
 
 // DEFINITION:
 // EACH GAMESCENE WRAPS AROUND A PHYSX SCENE
@@ -24,16 +44,42 @@ class GameScene {
 		physx::PxScene *_physxScene = nullptr;
 
 		void addEntity(std::shared_ptr<Entity> entity);
-		void removeEntity(std::shared_ptr<Entity> entity);
+		void removeEntity(std::shared_ptr<Entity> entity); // O(1) swap-and-pop (NOTE: changes the order of _entities)
+
+		std::shared_ptr<Entity> getEntity(EntityHandle handle); // nullptr if the handle is stale or null
+
+		// DESTROY QUEUE (filled by Entity::destroy(), drained by the broker at the end of each frame)...
+		void queueDestroy(EntityHandle handle) { _destroyQueue.push_back(handle); }
+		bool hasQueuedDestroys() { return !_destroyQueue.empty(); }
+		void takeDestroyQueue(std::vector<EntityHandle> &out) { out.clear(); out.swap(_destroyQueue); }
 
-		std::vector<std::shared_ptr<ShoppingCartPlayer>> getAllShoppingCartPlayers();
+		// TYPED REGISTRIES (kept up to date by addEntity/removeEntity, so these never allocate or cast)...
+		// NOTE: don't add/remove entities of the same type while iterating one of these
+		const std::vector<std::shared_ptr<Entity>>& getEntitiesOfType(EntityTypes type);
+		const std::vector<std::shared_ptr<ShoppingCartPlayer>>& getAllShoppingCartPlayers() { return _shoppingCartPlayers; } // in spawn order (index = player colour/viewport)
+		const std::vector<std::shared_ptr<SpareChange>>& getAllSpareChange() { return _spareChange; }
 
-		std::vector<std::shared_ptr<SpareChange>> getAllSpareChange();
 
+		std::vector<std::shared_ptr<Entity>> _entities; // dense, in no particular order
 
-		std::vector<std::shared_ptr<Entity>> _entities;
+		ComponentPools *_componentPools = nullptr; // SoA script/player/pickup state for every entity in this scene (see core/componentpools.h)
+		PickupActorPool *_pickupPool = nullptr; // if set, removed pickups get parked there instead of released (owned by the physics manager, see physics/pickuppool.h)
+		PickupGrid *_pickupGrid = nullptr; // if set, removed entities also leave it (owned by the physics manager, see physics/pickupgrid.h)
 
 	private:
+		struct EntitySlot {
+			uint32_t _generation = 0;
+			uint32_t _denseIndex = 0; // index into _entities
+			uint32_t _typeIndex = 0; // index into _entitiesByType[tag] (and the matching typed vector below)
+		};
+
+		std::vector<EntitySlot> _slots;
+		std::vector<uint32_t> _freeSlots;
+		std::vector<EntityHandle> _destroyQueue;
+
+		std::vector<std::vector<std::shared_ptr<Entity>>> _entitiesByType; // [EntityTypes]
+		std::vector<std::shared_ptr<ShoppingCartPlayer>> _shoppingCartPlayers; // mirrors _entitiesByType[SHOPPING_CART_PLAYER]
+		std::vector<std::shared_ptr<SpareChange>> _spareChange; // mirrors _entitiesByType[SPARE_CHANGE]
 };
 
 
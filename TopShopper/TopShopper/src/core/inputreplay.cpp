@@ -0,0 +1,319 @@
+#include "inputreplay.h"
+#include "vehicle/vehicleshoppingcart.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cstdlib>
+#include <cstring>
+
+using namespace physx;
+
+
+// BYTE STREAM HELPERS (same raw layout as core/snapshot.h)...
+
+template <typename T>
+static void append(std::vector<uint8_t> &stream, const T &value) {
+	const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&value);
+	stream.insert(stream.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool consume(const std::vector<uint8_t> &stream, size_t &offset, T &value) {
+	if (offset + sizeof(T) > stream.size()) return false;
+	memcpy(&value, stream.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return true;
+}
+
+
+
+bool CartInput::operator==(const CartInput &other) const {
+	if (_flags != other._flags) return false;
+	if (!(_flags & FED) || (_flags & KEYBOARD)) return true; // analog values are unused
+	return _accel == other._accel && _reverse == other._reverse && _handbrake == other._handbrake && _steer == other._steer;
+}
+
+
+
+void InputReplay::startRecording(const std::string &path) {
+	_mode = RECORDING;
+	_path = path;
+}
+
+
+bool InputReplay::loadReplay(const std::string &path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		std::cout << "ERROR: couldn't open replay " << path << std::endl;
+		return false;
+	}
+	_stream.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	// HEADER...
+	_readOffset = 0;
+	uint32_t magic = 0, version = 0;
+	uint8_t pipelined = 0, isWarmRestart = 0;
+	bool isValid = consume(_stream, _readOffset, magic)
+		&& consume(_stream, _readOffset, version)
+		&& consume(_stream, _readOffset, _seed)
+		&& consume(_stream, _readOffset, _nbPlayers)
+		&& consume(_stream, _readOffset, _nbCarts)
+		&& consume(_stream, _readOffset, _fixedDeltaTime)
+		&& consume(_stream, _readOffset, pipelined)
+		&& consume(_stream, _readOffset, isWarmRestart);
+	if (!isValid || magic != REPLAY_MAGIC || version != REPLAY_VERSION) {
+		std::cout << "ERROR: " << path << " is not a replay from this build" << std::endl;
+		_stream.clear();
+		return false;
+	}
+	_pipelined = pipelined != 0;
+	_streamStart = _readOffset;
+	_isWarmRestart = isWarmRestart != 0;
+
+	if (_isWarmRestart) {
+		std::cout << "WARNING: replay was recorded after a warm restart, it may not play back bit-for-bit" << std::endl;
+	}
+
+	_mode = PLAYING;
+	_path = path;
+	return true;
+}
+
+
+
+void InputReplay::beginMatch(int nbPlayers, int nbCarts, bool pipelined, bool isWarmRestart) {
+	if (_mode == RECORDING) {
+		endMatch(); // in case the last match never reached the end screen
+
+		// new seed per match (rand() has already been advanced by previous matches, so the main() seed alone isn't enough)...
+		_seed = (uint32_t)rand();
+		_nbPlayers = nbPlayers;
+		_nbCarts = nbCarts;
+		_pipelined = pipelined;
+		_isWarmRestart = isWarmRestart;
+		_stream.clear();
+	}
+	else if (_mode == PLAYING) {
+		_readOffset = _streamStart;
+	}
+	else {
+		return;
+	}
+
+	srand(_seed);
+	_stepInputs.clear();
+	_baseInputs.clear();
+	_nbFrames = 0;
+	_nbSteps = 0;
+	_nbDesyncs = 0;
+	_firstDesyncStep = -1;
+	_isMatchActive = true;
+}
+
+
+void InputReplay::endMatch() {
+	if (_mode != RECORDING || !_isMatchActive) return;
+	_isMatchActive = false;
+
+	append(_stream, (uint8_t)RECORD_END);
+
+	std::vector<uint8_t> header;
+	append(header, (uint32_t)REPLAY_MAGIC);
+	append(header, (uint32_t)REPLAY_VERSION);
+	append(header, _seed);
+	append(header, _nbPlayers);
+	append(header, _nbCarts);
+	append(header, _fixedDeltaTime);
+	append(header, (uint8_t)_pipelined);
+	append(header, (uint8_t)_isWarmRestart);
+
+	std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cout << "ERROR: couldn't write replay " << _path << std::endl;
+		return;
+	}
+	file.write((const char*)header.data(), header.size());
+	file.write((const char*)_stream.data(), _stream.size());
+
+	std::cout << "REPLAY: recorded " << _nbFrames << " frames / " << _nbSteps << " steps (" << (header.size() + _stream.size()) / 1024.0 << "KB) to " << _path << std::endl;
+}
+
+
+
+void InputReplay::recordFrame(double fixedDeltaTime, double variableDeltaTime, double accumulator) {
+	if (_mode != RECORDING || !_isMatchActive) return;
+
+	_fixedDeltaTime = fixedDeltaTime;
+	append(_stream, (uint8_t)RECORD_FRAME);
+	append(_stream, variableDeltaTime);
+	append(_stream, accumulator);
+	_nbFrames++;
+}
+
+
+bool InputReplay::nextFrame(double &variableDeltaTime, double &accumulator) {
+	if (_mode != PLAYING || !_isMatchActive) return false;
+
+	uint8_t recordType = 0;
+	if (!consume(_stream, _readOffset, recordType) || recordType == RECORD_END) {
+		_isMatchActive = false;
+		return false;
+	}
+	if (recordType != RECORD_FRAME || !consume(_stream, _readOffset, variableDeltaTime) || !consume(_stream, _readOffset, accumulator)) {
+		desync("expected a frame record");
+		return false;
+	}
+
+	_nbFrames++;
+	return true;
+}
+
+
+void InputReplay::beginPhysicsStep(size_t nbCarts) {
+	if (_mode == IDLE || !_isMatchActive) return;
+
+	// NOTE: never resized while the carts are feeding inputs (that happens in parallel)
+	_stepInputs.assign(nbCarts, CartInput());
+	if (_baseInputs.size() != nbCarts) _baseInputs.resize(nbCarts);
+
+	if (_mode == PLAYING) {
+		// apply this step's deltas...
+		uint8_t recordType = 0, nbChanged = 0;
+		if (!consume(_stream, _readOffset, recordType) || recordType != RECORD_STEP || !consume(_stream, _readOffset, nbChanged)) {
+			desync("expected a step record");
+			return;
+		}
+		for (uint8_t i = 0; i < nbChanged; i++) {
+			uint8_t cartIndex = 0;
+			CartInput input;
+			bool isValid = consume(_stream, _readOffset, cartIndex) && consume(_stream, _readOffset, input._flags);
+			if (isValid && (input._flags & CartInput::FED) && !(input._flags & CartInput::KEYBOARD)) {
+				isValid = consume(_stream, _readOffset, input._accel)
+					&& consume(_stream, _readOffset, input._reverse)
+					&& consume(_stream, _readOffset, input._handbrake)
+					&& consume(_stream, _readOffset, input._steer);
+			}
+			if (!isValid || cartIndex >= nbCarts) {
+				desync("corrupt step record");
+				return;
+			}
+			_baseInputs.at(cartIndex) = input;
+		}
+	}
+}
+
+
+void InputReplay::endPhysicsStep() {
+	if (_mode == IDLE || !_isMatchActive) return;
+
+	if (_mode == RECORDING) {
+		// DELTA ENCODING: only the carts whose input changed since the last step...
+		size_t countOffset = _stream.size() + 1;
+		append(_stream, (uint8_t)RECORD_STEP);
+		append(_stream, (uint8_t)0); // patched below
+		uint8_t nbChanged = 0;
+		for (size_t i = 0; i < _stepInputs.size(); i++) {
+			const CartInput &input = _stepInputs.at(i);
+			if (input == _baseInputs.at(i)) continue;
+
+			append(_stream, (uint8_t)i);
+			append(_stream, input._flags);
+			if ((input._flags & CartInput::FED) && !(input._flags & CartInput::KEYBOARD)) {
+				append(_stream, input._accel);
+				append(_stream, input._reverse);
+				append(_stream, input._handbrake);
+				append(_stream, input._steer);
+			}
+			_baseInputs.at(i) = input;
+			nbChanged++;
+		}
+		_stream.at(countOffset) = nbChanged;
+	}
+	else {
+		// every cart should have fed exactly what was recorded (humans trivially do, bots only if the sim hasn't diverged)...
+		for (size_t i = 0; i < _stepInputs.size(); i++) {
+			if (_stepInputs.at(i) != _baseInputs.at(i)) {
+				if (_firstDesyncStep < 0) _firstDesyncStep = (long long)_nbSteps;
+				_nbDesyncs++;
+				break;
+			}
+		}
+	}
+
+	_nbSteps++;
+}
+
+
+
+void InputReplay::recordControllerInput(uint32_t cartIndex, PxReal accel, PxReal reverse, PxReal handbrake, PxReal steer, bool turboButtonPressed) {
+	if (_mode == IDLE || !_isMatchActive) return;
+
+	CartInput input;
+	input._flags = (uint8_t)(CartInput::FED | (turboButtonPressed ? CartInput::TURBO : 0));
+	input._accel = accel;
+	input._reverse = reverse;
+	input._handbrake = handbrake;
+	input._steer = steer;
+	setInput(cartIndex, input);
+}
+
+
+void InputReplay::recordKeyboardInput(uint32_t cartIndex, bool accelKeyPressed, bool reverseKeyPressed, bool handbrakeKeyPressed, bool steerLeftKeyPressed, bool steerRightKeyPressed, bool turboKeyPressed) {
+	if (_mode == IDLE || !_isMatchActive) return;
+
+	CartInput input;
+	input._flags = (uint8_t)(CartInput::FED | CartInput::KEYBOARD
+		| (accelKeyPressed ? CartInput::ACCEL : 0)
+		| (reverseKeyPressed ? CartInput::REVERSE : 0)
+		| (handbrakeKeyPressed ? CartInput::HANDBRAKE : 0)
+		| (steerLeftKeyPressed ? CartInput::STEER_LEFT : 0)
+		| (steerRightKeyPressed ? CartInput::STEER_RIGHT : 0)
+		| (turboKeyPressed ? CartInput::TURBO : 0));
+	setInput(cartIndex, input);
+}
+
+
+void InputReplay::feedRecordedInput(uint32_t cartIndex, VehicleShoppingCart *vehicle) {
+	if (_mode != PLAYING || !_isMatchActive || cartIndex >= _baseInputs.size()) return;
+
+	const CartInput &input = _baseInputs.at(cartIndex);
+	if (!(input._flags & CartInput::FED)) return; // this cart had no input device during the recording
+	setInput(cartIndex, input);
+
+	bool isTurbo = (input._flags & CartInput::TURBO) != 0;
+	if (input._flags & CartInput::KEYBOARD) {
+		vehicle->processRawInputDataKeyboard((input._flags & CartInput::ACCEL) != 0, (input._flags & CartInput::REVERSE) != 0, (input._flags & CartInput::HANDBRAKE) != 0,
+			(input._flags & CartInput::STEER_LEFT) != 0, (input._flags & CartInput::STEER_RIGHT) != 0, isTurbo);
+	}
+	else {
+		vehicle->processRawInputDataController(input._accel, input._reverse, input._handbrake, input._steer, isTurbo);
+	}
+}
+
+
+void InputReplay::printSummary() {
+	if (_mode != PLAYING) return;
+
+	std::cout << "REPLAY: played " << _nbFrames << " frames / " << _nbSteps << " steps (seed " << _seed << ")" << std::endl;
+	if (_nbDesyncs == 0) {
+		std::cout << "REPLAY: no desyncs, every bot fed the recorded input" << std::endl;
+	}
+	else {
+		std::cout << "REPLAY: " << _nbDesyncs << " desynced steps (first at step " << _firstDesyncStep << ")" << std::endl;
+	}
+}
+
+
+
+void InputReplay::setInput(uint32_t cartIndex, const CartInput &input) {
+	if (cartIndex >= _stepInputs.size()) return;
+	_stepInputs[cartIndex] = input;
+}
+
+
+void InputReplay::desync(const char *reason) {
+	std::cout << "ERROR: replay stream " << reason << " at step " << _nbSteps << ", stopping playback" << std::endl;
+	if (_firstDesyncStep < 0) _firstDesyncStep = (long long)_nbSteps;
+	_nbDesyncs++;
+	_isMatchActive = false;
+}
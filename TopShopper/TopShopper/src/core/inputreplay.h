@@ -0,0 +1,133 @@
+#ifndef INPUTREPLAY_H_
+#define INPUTREPLAY_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <foundation/PxSimpleTypes.h>
+
+
+class VehicleShoppingCart;
+
+
+// DEFINITION:
+// INPUT RECORDING / REPLAY (1 per program, owned by the broker)
+// records everything a match needs to be re-simulated bit-for-bit: the rand() seed, the frame timing (delta time + accumulator of every GAME frame)
+// and the raw inputs every cart fed into VehicleShoppingCart::processRawInputDataController() / processRawInputDataKeyboard() on every physics step.
+// the replay then runs headless at max speed (run with --replay <file>), so perf changes can be profiled on the exact same workload.
+//
+// PLAYBACK:
+// - human carts get their recorded inputs fed straight into their vehicle instead of reading the input devices
+// - bots still run their AI (so the AI cost is part of the profile), and their inputs get compared against the recording to catch desyncs
+//
+// FILE LAYOUT:
+//		header (magic, version, seed, nb of players, nb of carts, fixed delta time, pipelined flag, warm restart flag)
+//		stream of records: FRAME (delta time + accumulator) | STEP (only the carts whose input changed since the previous step) | END
+//
+// NOTE: a match that was recorded after a warm restart may not replay bit-for-bit, since the replay always does a cold load (the warm flag is there to tell them apart)
+// NOTE: each cart only ever touches its own slot in the record methods, so they can be called from job workers too
+
+
+#define REPLAY_MAGIC 0x50525354 // "TSRP"
+#define REPLAY_VERSION 2 // 2: + nb of carts
+
+
+struct CartInput {
+	enum Flags {
+		FED			= (1 << 0), // a process method was called this step (e.g. not set for a human without an input device)
+		KEYBOARD	= (1 << 1), // processRawInputDataKeyboard() instead of processRawInputDataController()
+		ACCEL		= (1 << 2), // keyboard only...
+		REVERSE		= (1 << 3),
+		HANDBRAKE	= (1 << 4),
+		STEER_LEFT	= (1 << 5),
+		STEER_RIGHT	= (1 << 6),
+		TURBO		= (1 << 7) // both
+	};
+
+	bool operator==(const CartInput &other) const;
+	bool operator!=(const CartInput &other) const { return !(*this == other); }
+
+	uint8_t _flags = 0;
+	physx::PxReal _accel = 0.0f; // controller only...
+	physx::PxReal _reverse = 0.0f;
+	physx::PxReal _handbrake = 0.0f;
+	physx::PxReal _steer = 0.0f;
+};
+
+
+
+class InputReplay {
+public:
+	enum Modes {
+		IDLE,
+		RECORDING,
+		PLAYING
+	};
+
+	Modes getMode() { return _mode; }
+	bool isRecording() { return _mode == RECORDING; }
+	bool isPlaying() { return _mode == PLAYING; }
+
+	void startRecording(const std::string &path); // the next match (and every one after it) gets recorded, the file is written when the match ends
+	bool loadReplay(const std::string &path); // returns false if the file couldn't be read or isn't a replay
+
+	// REPLAY HEADER (valid after loadReplay())...
+	int getNbPlayers() { return _nbPlayers; }
+	int getNbCarts() { return _nbCarts; }
+	double getFixedDeltaTime() { return _fixedDeltaTime; }
+	bool getPipelined() { return _pipelined; }
+
+	// BROKER / PHYSICS HOOKS...
+	void beginMatch(int nbPlayers, int nbCarts, bool pipelined, bool isWarmRestart); // (re)seeds rand(), call before anything in the match uses it
+	void endMatch(); // writes the recording (safe to call more than once)
+	void recordFrame(double fixedDeltaTime, double variableDeltaTime, double accumulator); // every GAME frame, right before the physics steps
+	bool nextFrame(double &variableDeltaTime, double &accumulator); // playback: false once the recording runs out
+	void beginPhysicsStep(size_t nbCarts); // before any cart gets its input
+	void endPhysicsStep(); // after every cart got its input
+
+	// CART HOOKS (cartIndex = index in the player pool)...
+	void recordControllerInput(uint32_t cartIndex, physx::PxReal accel, physx::PxReal reverse, physx::PxReal handbrake, physx::PxReal steer, bool turboButtonPressed);
+	void recordKeyboardInput(uint32_t cartIndex, bool accelKeyPressed, bool reverseKeyPressed, bool handbrakeKeyPressed, bool steerLeftKeyPressed, bool steerRightKeyPressed, bool turboKeyPressed);
+	void feedRecordedInput(uint32_t cartIndex, VehicleShoppingCart *vehicle); // playback: replays this step's recorded input into the vehicle
+
+	void printSummary();
+	unsigned long long getNbDesyncs() { return _nbDesyncs; } // of the last match played back
+
+private:
+	enum RecordTypes {
+		RECORD_FRAME = 1,
+		RECORD_STEP = 2,
+		RECORD_END = 3
+	};
+
+	void setInput(uint32_t cartIndex, const CartInput &input);
+	void desync(const char *reason);
+
+	Modes _mode = IDLE;
+	std::string _path;
+	bool _isMatchActive = false;
+
+	// HEADER...
+	uint32_t _seed = 0;
+	int _nbPlayers = 1;
+	int _nbCarts = 6;
+	double _fixedDeltaTime = 1.0 / 60.0;
+	bool _pipelined = false;
+	bool _isWarmRestart = false;
+
+	std::vector<uint8_t> _stream; // records (recording: appended to, playback: whole file, read from _readOffset)
+	size_t _streamStart = 0; // playback: first record (right after the header)
+	size_t _readOffset = 0;
+
+	std::vector<CartInput> _stepInputs; // [cartIndex] what each cart fed in this step
+	std::vector<CartInput> _baseInputs; // [cartIndex] last written (recording) / last decoded (playback) input, the deltas are relative to this
+
+	unsigned long long _nbFrames = 0;
+	unsigned long long _nbSteps = 0;
+	unsigned long long _nbDesyncs = 0;
+	long long _firstDesyncStep = -1;
+};
+
+
+
+#endif // INPUTREPLAY_H_
@@ -0,0 +1,268 @@
+#include "jobsystem.h"
+#include "utility/profiler.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace physx;
+
+
+thread_local int gJobWorkerIndex = -1; // -1 = not a job system worker (e.g. main thread)
+
+
+
+JobSystem::JobSystem(unsigned int nbWorkers) {
+	startWorkers(nbWorkers);
+}
+
+
+JobSystem::~JobSystem() {
+	stopWorkers();
+}
+
+
+unsigned int JobSystem::getDefaultWorkerCount() {
+	unsigned int nbHardwareThreads = std::thread::hardware_concurrency();
+	return nbHardwareThreads > 1 ? nbHardwareThreads - 1 : 0; // hardware_concurrency() can return 0 if unknown
+}
+
+
+void JobSystem::setNbWorkers(unsigned int nbWorkers) {
+	if (nbWorkers == _workers.size()) return;
+	stopWorkers();
+	startWorkers(nbWorkers);
+}
+
+
+
+JobHandle JobSystem::createJob(std::function<void()> work) {
+	return std::make_shared<Job>(work);
+}
+
+
+void JobSystem::addDependency(JobHandle job, JobHandle dependsOn) {
+	if (dependsOn == nullptr) return;
+
+	std::lock_guard<std::mutex> lock(dependsOn->_continuationsMutex);
+	if (dependsOn->isDone()) return; // already finished, nothing to wait for
+	job->_nbUnfinishedDependencies.fetch_add(1);
+	dependsOn->_continuations.push_back(job);
+}
+
+
+void JobSystem::submit(JobHandle job) {
+	// release the submit hold, if no dependencies are left the job is ready to go...
+	if (job->_nbUnfinishedDependencies.fetch_sub(1) == 1) {
+		enqueue(job);
+	}
+}
+
+
+JobHandle JobSystem::schedule(std::function<void()> work, const std::vector<JobHandle> &dependencies) {
+	JobHandle job = createJob(work);
+	for (const JobHandle &dependency : dependencies) {
+		addDependency(job, dependency);
+	}
+	submit(job);
+	return job;
+}
+
+
+void JobSystem::wait(JobHandle job) {
+	if (job == nullptr) return;
+	int queue = gJobWorkerIndex >= 0 ? gJobWorkerIndex : (int)_workers.size();
+	while (!job->isDone()) {
+		if (!tryRunOneJob(queue)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+
+void JobSystem::submitPhysXTask(PxBaseTask *task) {
+	QueuedWork work;
+	work._task = task;
+	enqueueWork(work);
+}
+
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, std::function<void(size_t begin, size_t end)> body) {
+	if (count == 0) return;
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	// not worth splitting...
+	if (_workers.empty() || count <= grainSize) {
+		body(0, count);
+		return;
+	}
+
+	std::vector<JobHandle> chunks;
+	size_t begin = 0;
+	for (; begin + grainSize < count; begin += grainSize) {
+		size_t end = begin + grainSize;
+		chunks.push_back(schedule([body, begin, end]() { body(begin, end); }));
+	}
+
+	body(begin, count); // run the last chunk on this thread
+
+	for (JobHandle &chunk : chunks) {
+		wait(chunk);
+	}
+}
+
+
+
+void JobSystem::startWorkers(unsigned int nbWorkers) {
+	// 1 queue per worker + 1 shared queue (last) for jobs submitted from outside the pool...
+	_queues.clear();
+	for (unsigned int i = 0; i < nbWorkers + 1; i++) {
+		_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+	}
+
+	_isShuttingDown.store(false);
+	for (unsigned int i = 0; i < nbWorkers; i++) {
+		_workers.push_back(std::thread(&JobSystem::workerLoop, this, (int)i));
+	}
+}
+
+
+void JobSystem::stopWorkers() {
+	_isShuttingDown.store(true);
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_sleepCondition.notify_all();
+	}
+	for (std::thread &worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+}
+
+
+
+void JobSystem::enqueue(JobHandle job) {
+	QueuedWork work;
+	work._job = job;
+	enqueueWork(work);
+}
+
+
+void JobSystem::enqueueWork(const QueuedWork &work) {
+	// no workers, just run it right away...
+	if (_workers.empty()) {
+		QueuedWork inlineWork = work;
+		executeWork(inlineWork);
+		return;
+	}
+
+	int queue = gJobWorkerIndex >= 0 ? gJobWorkerIndex : (int)_workers.size();
+	{
+		std::lock_guard<std::mutex> lock(_queues.at(queue)->_mutex);
+		_queues.at(queue)->_jobs.push_back(work);
+	}
+	_nbQueuedJobs.fetch_add(1);
+
+	std::lock_guard<std::mutex> lock(_sleepMutex);
+	_sleepCondition.notify_one();
+}
+
+
+void JobSystem::execute(JobHandle job) {
+	{
+		PROFILE_SCOPE("JobSystem::job");
+		job->_work();
+	}
+
+	// mark done and release anything that was waiting on this job...
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard<std::mutex> lock(job->_continuationsMutex);
+		job->_isDone.store(true, std::memory_order_release);
+		continuations.swap(job->_continuations);
+	}
+	for (JobHandle &continuation : continuations) {
+		if (continuation->_nbUnfinishedDependencies.fetch_sub(1) == 1) {
+			enqueue(continuation);
+		}
+	}
+}
+
+
+void JobSystem::executeWork(QueuedWork &work) {
+	if (work._task != nullptr) {
+		PROFILE_SCOPE("JobSystem::physxTask");
+		work._task->run();
+		work._task->release();
+		return;
+	}
+	execute(work._job);
+}
+
+
+bool JobSystem::tryRunOneJob(int preferredQueue) {
+	QueuedWork work;
+	if (!popOrSteal(preferredQueue, work)) return false;
+	executeWork(work);
+	return true;
+}
+
+
+bool JobSystem::popOrSteal(int preferredQueue, QueuedWork &work) {
+	if (_nbQueuedJobs.load() <= 0) return false;
+
+	// own queue first (newest job)...
+	{
+		WorkerQueue &own = *_queues.at(preferredQueue);
+		std::lock_guard<std::mutex> lock(own._mutex);
+		if (!own._jobs.empty()) {
+			work = std::move(own._jobs.back());
+			own._jobs.pop_back();
+			_nbQueuedJobs.fetch_sub(1);
+			return true;
+		}
+	}
+
+	// then steal the oldest job from someone else (start at a rotating victim so we don't all hammer queue 0)...
+	unsigned int nbQueues = (unsigned int)_queues.size();
+	unsigned int start = _nextQueue.fetch_add(1) % nbQueues;
+	for (unsigned int i = 0; i < nbQueues; i++) {
+		unsigned int victim = (start + i) % nbQueues;
+		if (victim == (unsigned int)preferredQueue) continue;
+
+		WorkerQueue &other = *_queues.at(victim);
+		std::lock_guard<std::mutex> lock(other._mutex);
+		if (!other._jobs.empty()) {
+			work = std::move(other._jobs.front());
+			other._jobs.pop_front();
+			_nbQueuedJobs.fetch_sub(1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void JobSystem::workerLoop(int workerIndex) {
+	gJobWorkerIndex = workerIndex;
+
+	while (!_isShuttingDown.load()) {
+		if (tryRunOneJob(workerIndex)) continue;
+
+		// nothing to do, sleep until new work shows up (timeout is just a safety net against missed wakeups)...
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_sleepCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return _isShuttingDown.load() || _nbQueuedJobs.load() > 0; });
+	}
+}
+
+
+
+// PHYSX DISPATCHER...
+
+void JobSystemCpuDispatcher::submitTask(PxBaseTask &task) {
+	_jobSystem->submitPhysXTask(&task); // NOTE: no Job/std::function per task, PhysX submits a lot of small ones every step
+}
+
+
+uint32_t JobSystemCpuDispatcher::getWorkerCount() const {
+	return _jobSystem->getNbWorkers();
+}
@@ -0,0 +1,123 @@
+#ifndef JOBSYSTEM_H_
+#define JOBSYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "task/PxCpuDispatcher.h"
+#include "task/PxTask.h"
+
+
+// DEFINITION:
+// WORK-STEALING JOB SYSTEM (1 per program, owned by the broker)
+// - each worker thread owns a deque of jobs. it pops its own work from the back (LIFO, cache warm) and when empty steals from the front of another worker's deque (FIFO)
+// - any thread that waits on a job helps out by running other jobs instead of blocking, so the main thread is effectively an extra worker
+// - jobs can depend on other jobs (task graph), a job only gets queued once all of its dependencies have finished
+// - PhysX gets fed through JobSystemCpuDispatcher below, so physics and our own jobs share the same threads (no oversubscription)
+//
+// USAGE:
+//		JobHandle a = jobSystem->schedule([]() { ... });
+//		JobHandle b = jobSystem->schedule([]() { ... }, { a }); // b runs after a
+//		jobSystem->wait(b);
+//		jobSystem->parallelFor(n, 16, [&](size_t begin, size_t end) { for (size_t i = begin; i < end; i++) {...} });
+//
+// NOTE: jobs must not touch GL (only the main thread owns the context) and must only write to data that no other concurrent job touches.
+// NOTE: PhysX tasks go into the queues as is (no Job gets allocated for them), PhysX already tracks their dependencies itself
+
+
+class Job {
+public:
+	Job(std::function<void()> work) : _work(work) {}
+
+	bool isDone() { return _isDone.load(std::memory_order_acquire); }
+
+private:
+	friend class JobSystem;
+
+	std::function<void()> _work;
+	std::atomic<int> _nbUnfinishedDependencies{ 1 }; // +1 held until submit() so the job can't start while dependencies are still being added
+	std::atomic<bool> _isDone{ false };
+	std::mutex _continuationsMutex;
+	std::vector<std::shared_ptr<Job>> _continuations; // jobs waiting on this one
+};
+
+typedef std::shared_ptr<Job> JobHandle;
+
+
+
+class JobSystem {
+public:
+	JobSystem(unsigned int nbWorkers); // 0 = run everything inline on the calling thread
+	virtual ~JobSystem();
+
+	static unsigned int getDefaultWorkerCount(); // nb of hardware threads - 1 (the main thread helps while waiting)
+	unsigned int getNbWorkers() { return (unsigned int)_workers.size(); }
+	void setNbWorkers(unsigned int nbWorkers); // joins and respawns the worker threads (--physics-workers, thread scaling benchmark)
+	// NOTE: only call setNbWorkers() when nothing is queued or running (e.g. between matches, with no step in flight)
+
+	// TASK GRAPH...
+	JobHandle createJob(std::function<void()> work); // NOTE: not queued until submit()
+	void addDependency(JobHandle job, JobHandle dependsOn); // must be called before submit(job)
+	void submit(JobHandle job);
+	JobHandle schedule(std::function<void()> work, const std::vector<JobHandle> &dependencies = {}); // create + add deps + submit
+	void wait(JobHandle job); // runs other jobs until this one is done
+	void submitPhysXTask(physx::PxBaseTask *task); // queued like a job without dependencies, run() + release() on whatever thread picks it up
+
+	// splits [0, count) into chunks of at most grainSize and blocks until every chunk is done
+	void parallelFor(size_t count, size_t grainSize, std::function<void(size_t begin, size_t end)> body);
+
+private:
+	// a queue entry is either one of our jobs or a PhysX task...
+	struct QueuedWork {
+		JobHandle _job;
+		physx::PxBaseTask *_task = nullptr;
+	};
+
+	struct WorkerQueue {
+		std::mutex _mutex;
+		std::deque<QueuedWork> _jobs;
+	};
+
+	void startWorkers(unsigned int nbWorkers);
+	void stopWorkers();
+
+	void enqueue(JobHandle job);
+	void enqueueWork(const QueuedWork &work);
+	void execute(JobHandle job);
+	void executeWork(QueuedWork &work);
+	bool tryRunOneJob(int preferredQueue);
+	bool popOrSteal(int preferredQueue, QueuedWork &work); // false if every queue is empty
+	void workerLoop(int workerIndex);
+
+	std::vector<std::thread> _workers;
+	std::vector<std::unique_ptr<WorkerQueue>> _queues; // 1 per worker + 1 shared for the main thread / non-worker threads
+
+	std::atomic<int> _nbQueuedJobs{ 0 };
+	std::atomic<unsigned int> _nextQueue{ 0 };
+	std::atomic<bool> _isShuttingDown{ false };
+	std::mutex _sleepMutex;
+	std::condition_variable _sleepCondition;
+};
+
+
+
+// PhysX cpu dispatcher backed by the job system...
+class JobSystemCpuDispatcher : public physx::PxCpuDispatcher {
+public:
+	JobSystemCpuDispatcher(JobSystem *jobSystem) : _jobSystem(jobSystem) {}
+
+	void submitTask(physx::PxBaseTask &task) override;
+	uint32_t getWorkerCount() const override;
+
+private:
+	JobSystem *_jobSystem = nullptr;
+};
+
+
+
+#endif // JOBSYSTEM_H_
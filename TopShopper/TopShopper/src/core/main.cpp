@@ -1,21 +1,140 @@
 #include "broker.h"
+#include "benchmark.h"
+#include "utility/profiler.h"
 #include <iostream>
-#include <Windows.h>
 #include <ctime>
+#include <chrono>
+#include <cstring>
 
-int main() {
+// HEADLESS MODE (run with --headless):
+// rendering, audio and input are swapped for null backends and the sim is driven by a synthetic clock,
+// so a full match (AIManager::_matchTimer) runs as fast as the CPU allows and reports simulated steps per second.
+// NOTE: it's a runtime mode of the normal build, the exe still links GLFW/GL/SDL (they just never get initialized), so it needs the same DLLs to start
+// REPLAY MODE (run with --replay <file>): same thing, but the frame timing and human inputs come from a recorded match (see core/inputreplay.h)
+int runHeadless(Broker *broker, const double fixedDeltaTime) {
+	InputReplay *inputReplay = broker->getInputReplay();
+	double simTime = 0.0;
+	double accumulator = 0.0;
+	double variableDeltaTime = fixedDeltaTime; // synthetic clock: every frame advances by exactly 1 fixed step
+	unsigned long long nbSteps = 0;
+
+	broker->startHeadlessMatch();
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	while (broker->_scene == GAME) {
+		if (inputReplay->isPlaying()) {
+			if (!inputReplay->nextFrame(variableDeltaTime, accumulator)) break; // recording ended (e.g. the match was quit early)
+		}
+		else {
+			accumulator += variableDeltaTime;
+		}
+		broker->updateAllSeconds(simTime, fixedDeltaTime, variableDeltaTime, accumulator);
+		nbSteps++;
+	}
+	std::chrono::steady_clock::time_point wallEnd = std::chrono::steady_clock::now();
 
-	srand(time(NULL)); // set the seed for all calls to rand(), seed will be different on every run of program 
+	double wallSeconds = std::chrono::duration<double>(wallEnd - wallStart).count();
+	double stepsPerSecond = wallSeconds > 0.0 ? nbSteps / wallSeconds : 0.0;
+
+	std::cout << "HEADLESS: simulated " << simTime << "s (" << nbSteps << " steps) in " << wallSeconds << "s wall time" << std::endl;
+	std::cout << "HEADLESS: " << stepsPerSecond << " steps/sec (" << (wallSeconds > 0.0 ? simTime / wallSeconds : 0.0) << "x realtime)" << std::endl;
+	inputReplay->printSummary();
+
+	if (Profiler::isEnabled()) {
+		Profiler::dumpChromeTrace("profile.json");
+	}
+
+	inputReplay->endMatch(); // headless matches can be recorded too
+	broker->getPhysicsManager()->getPvdCapture()->stopCapture(); // an unbounded capture still gets closed properly
+	broker->getPhysicsManager()->cleanupScene1();
+	broker->getAIManager()->cleanupScene1();
+	return 0;
+}
+
+
+int main(int argc, char **argv) {
+
+	srand(time(NULL)); // set the seed for all calls to rand(), seed will be different on every run of program
 
 	// initial loading... (slow)
 	Broker *broker = Broker::getInstance();
+	double physicsHz = 60.0;
+	std::string benchmarkPath; // empty = not benchmarking
+	std::string threadScalingPath; // empty = not measuring thread scaling
+	double benchmarkSeconds = 60.0;
+	bool cookCollision = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--headless") == 0) broker->_headless = true;
+		if (strcmp(argv[i], "--profile") == 0) Profiler::setEnabled(true); // dump with F9 (or automatically at the end of a headless match)
+		if (strcmp(argv[i], "--pipelined-physics") == 0) broker->getPhysicsManager()->_pipelined = true; // overlap the last physics step of each frame with rendering
+		if (strcmp(argv[i], "--cold-restart") == 0) broker->_warmRestart = false; // tear down + rebuild the whole PhysX scene between matches
+		if (strcmp(argv[i], "--carts") == 0 && i + 1 < argc) broker->getPhysicsManager()->_nbVehicles = atoi(argv[++i]); // humans + bots (max 64), more than 6 spawn in generated rings
+		if (strcmp(argv[i], "--physics-hz") == 0 && i + 1 < argc) physicsHz = atof(argv[++i]); // e.g. 30 on weaker machines (rendering interpolates between steps)
+		if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) { // headless benchmark suite, results get written to this JSON file
+			benchmarkPath = argv[++i];
+			broker->_headless = true;
+		}
+		if (strcmp(argv[i], "--physics-workers") == 0 && i + 1 < argc) broker->getJobSystem()->setNbWorkers((unsigned int)atoi(argv[++i])); // job system threads (PhysX runs on them too), defaults to hardware threads - 1, 0 = everything on the main thread
+		if (strcmp(argv[i], "--thread-scaling") == 0 && i + 1 < argc) { // plays the --replay match at 0/1/2/4/8 workers, results get written to this JSON file
+			threadScalingPath = argv[++i];
+			broker->_headless = true;
+		}
+		if (strcmp(argv[i], "--bench-seconds") == 0 && i + 1 < argc) benchmarkSeconds = atof(argv[++i]); // simulated length of each benchmark match (max 300, the match timer)
+		if (strcmp(argv[i], "--cook-collision") == 0) { // offline step: cooks the static map collision meshes into resources/cooked/ and exits
+			cookCollision = true;
+			broker->_headless = true;
+		}
+		if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) broker->getInputReplay()->startRecording(argv[++i]); // writes each match to this file when it ends
+		if (strcmp(argv[i], "--pvd-host") == 0 && i + 1 < argc) broker->getPhysicsManager()->_pvdSettings._host = argv[++i]; // streams to a running PhysX Visual Debugger at this IP (PVD_ENABLED builds)
+		if (strcmp(argv[i], "--pvd-capture") == 0 && i + 1 < argc) { // writes a PVD capture file instead (F10 starts/stops more at runtime, numbered _1, _2, ...)
+			broker->getPhysicsManager()->_pvdSettings._capturePath = argv[++i];
+			broker->getPhysicsManager()->_pvdSettings._captureAtStart = true;
+		}
+		if (strcmp(argv[i], "--pvd-frames") == 0 && i + 1 < argc) broker->getPhysicsManager()->_pvdSettings._nbCaptureSteps = (unsigned int)atoi(argv[++i]); // physics steps per capture, 0 = until F10
+		if (strcmp(argv[i], "--pvd-capture-from") == 0 && i + 1 < argc) broker->getPhysicsManager()->_pvdSettings._captureFromStep = (unsigned long long)atoll(argv[++i]); // --pvd-capture starts this many physics steps in
+		if (strcmp(argv[i], "--pvd-flags") == 0 && i + 1 < argc) broker->getPhysicsManager()->_pvdSettings._flags = argv[++i]; // e.g. debug,profile (default all)
+		if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) { // re-simulates a recorded match headless at max speed
+			if (!broker->getInputReplay()->loadReplay(argv[++i])) return 1;
+			broker->_headless = true;
+		}
+	}
+	if (physicsHz <= 0.0) {
+		std::cout << "ERROR: invalid --physics-hz, using 60" << std::endl;
+		physicsHz = 60.0;
+	}
+
+	// a replay has to run with the same step settings it was recorded with...
+	if (broker->getInputReplay()->isPlaying()) {
+		broker->getPhysicsManager()->_pipelined = broker->getInputReplay()->getPipelined();
+		broker->getPhysicsManager()->_nbVehicles = broker->getInputReplay()->getNbCarts();
+	}
 	broker->initAll();
-	GLFWwindow *window = broker->getRenderingManager()->getWindow();
 
-	// !!!NOTE: all time variables are in SECONDS!!! 
+	if (cookCollision) {
+		return broker->getPhysicsManager()->cookStaticMeshes() ? 0 : 1;
+	}
+
+	// !!!NOTE: all time variables are in SECONDS!!!
 	// SIMILAR TO https://gafferongames.com/post/fix_your_timestep/
+	const double fixedDeltaTime = broker->getInputReplay()->isPlaying() ? broker->getInputReplay()->getFixedDeltaTime() : 1.0 / physicsHz; // (exact recorded value, 1/(1/x) can be off by an ulp)
+
+	if (!benchmarkPath.empty()) {
+		Benchmark benchmark(broker);
+		return benchmark.run(fixedDeltaTime, benchmarkSeconds, benchmarkPath);
+	}
+
+	if (!threadScalingPath.empty()) {
+		Benchmark benchmark(broker);
+		return benchmark.runThreadScaling(fixedDeltaTime, threadScalingPath);
+	}
+
+	if (broker->_headless) {
+		return runHeadless(broker, fixedDeltaTime);
+	}
+
+	GLFWwindow *window = broker->getRenderingManager()->getWindow();
+
 	double simTime = 0.0; // total accumulation of simulated physics timesteps
-	const double fixedDeltaTime = 1.0 / 60.0;
 	double prevTime = glfwGetTime(); // needs to be set here after initialization, gets time in SECONDS!!!
 	double accumulator = 0.0;
 
@@ -34,5 +153,7 @@ int main() {
 	}
 
 	// if main loop ends, call cleanup
+	broker->getInputReplay()->endMatch(); // window closed mid-match
+	broker->getPhysicsManager()->getPvdCapture()->stopCapture();
 	return 0;
-}
\ No newline at end of file
+}
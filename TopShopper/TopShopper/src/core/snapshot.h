@@ -0,0 +1,89 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <foundation/PxTransform.h>
+
+
+// GAME-STATE SNAPSHOTS...
+// the whole simulation state gets packed into a flat binary blob (see Broker::captureSnapshot() / restoreSnapshot())
+// each system appends its own section in a fixed order through writeSnapshot(SnapshotWriter&) and reads it back in the same order through readSnapshot(SnapshotReader&)
+// NOTE: the blob is raw memory (no endianness / padding handling), so it's only meant to be restored by the same build on the same machine
+// NOTE: bump SNAPSHOT_VERSION whenever a section's layout changes
+// NOTE: the PhysX math types have user-defined copies (not trivially copyable), so they get written field by field through the overloads below
+
+#define SNAPSHOT_MAGIC 0x4E535354 // "TSSN"
+#define SNAPSHOT_VERSION 2
+
+
+class SnapshotWriter {
+public:
+	SnapshotWriter(std::vector<uint8_t> &blob) : _blob(blob) { _blob.clear(); } // NOTE: clear() keeps the capacity, so reusing the same blob doesn't allocate
+
+	template <typename T>
+	void write(const T &value) {
+		static_assert(std::is_trivially_copyable<T>::value, "snapshots can only hold plain data");
+		const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&value);
+		_blob.insert(_blob.end(), bytes, bytes + sizeof(T));
+	}
+
+	void write(const physx::PxVec3 &value) { write(value.x); write(value.y); write(value.z); }
+	void write(const physx::PxQuat &value) { write(value.x); write(value.y); write(value.z); write(value.w); }
+	void write(const physx::PxTransform &value) { write(value.q); write(value.p); }
+
+private:
+	std::vector<uint8_t> &_blob;
+};
+
+
+class SnapshotReader {
+public:
+	SnapshotReader(const std::vector<uint8_t> &blob) : _blob(blob) {}
+
+	// returns false (and leaves value untouched) if the blob is too short, after that every read fails
+	template <typename T>
+	bool read(T &value) {
+		static_assert(std::is_trivially_copyable<T>::value, "snapshots can only hold plain data");
+		if (_hasFailed || _offset + sizeof(T) > _blob.size()) {
+			_hasFailed = true;
+			return false;
+		}
+		memcpy(&value, _blob.data() + _offset, sizeof(T));
+		_offset += sizeof(T);
+		return true;
+	}
+
+	bool read(physx::PxVec3 &value) {
+		physx::PxVec3 v;
+		if (!read(v.x) || !read(v.y) || !read(v.z)) return false;
+		value = v;
+		return true;
+	}
+	bool read(physx::PxQuat &value) {
+		physx::PxQuat q;
+		if (!read(q.x) || !read(q.y) || !read(q.z) || !read(q.w)) return false;
+		value = q;
+		return true;
+	}
+	bool read(physx::PxTransform &value) {
+		physx::PxTransform t;
+		if (!read(t.q) || !read(t.p)) return false;
+		value = t;
+		return true;
+	}
+
+	bool hasFailed() { return _hasFailed; }
+	bool isAtEnd() { return _offset == _blob.size(); }
+
+private:
+	const std::vector<uint8_t> &_blob;
+	size_t _offset = 0;
+	bool _hasFailed = false;
+};
+
+
+
+#endif // SNAPSHOT_H_
@@ -1,6 +1,7 @@
 //TODO: can maybe include a callback of some kind which detects the connecting and disconnecting of controllers in real time.
 #include "inputmanager.h"
 #include "core/broker.h"
+#include "utility/profiler.h"
 
 InputManager::InputManager(Broker *broker)
 	: _broker(broker)
@@ -10,6 +11,9 @@ InputManager::InputManager(Broker *broker)
 
 //detects the amount of gamepads currently connected to the machine (can maybe take the number of players and init that way instead, but you would have to validate the input)
 void InputManager::init(){
+	_numGamepads = 0;
+	if (_broker->_headless) return; // NULL BACKEND: no gamepads, keyboard state stays zeroed
+
 
 	while (glfwJoystickPresent(_joySticks[_numGamepads])) {	//tallies the amount of connected gamepads and initializes a struct for each of them.
 		_numGamepads++;
@@ -20,6 +24,8 @@ void InputManager::init(){
 
 //updates the states of each of the gamepad structs in the gamepads array when called
 void InputManager::updateSeconds(double variableDeltaTime) {
+	PROFILE_SCOPE("InputManager::updateSeconds");
+	if (_broker->_headless) return; // NULL BACKEND: nothing to poll without a window
 
 	glfwPollEvents(); // NOTE: I MOVED THIS HERE FROM THE RENDERING CODE SINCE IT DIDNT WORK OTHERWISE
 
@@ -108,6 +114,14 @@ void InputManager::updateSeconds(double variableDeltaTime) {
 	bool newEnterKeyState = GLFW_PRESS == glfwGetKey(window, GLFW_KEY_ENTER);
 	_keyboardAndMouse->enterKeyJustPressed = (!_keyboardAndMouse->enterKey && newEnterKeyState);
 	_keyboardAndMouse->enterKey = newEnterKeyState;
+
+	bool newF9KeyState = GLFW_PRESS == glfwGetKey(window, GLFW_KEY_F9);
+	_keyboardAndMouse->f9KeyJustPressed = (!_keyboardAndMouse->f9Key && newF9KeyState);
+	_keyboardAndMouse->f9Key = newF9KeyState;
+
+	bool newF10KeyState = GLFW_PRESS == glfwGetKey(window, GLFW_KEY_F10);
+	_keyboardAndMouse->f10KeyJustPressed = (!_keyboardAndMouse->f10Key && newF10KeyState);
+	_keyboardAndMouse->f10Key = newF10KeyState;
 }
 
 //returns a pointer to the structure representing the gamepad number given as a parameter (1,2,3,4)
@@ -50,6 +50,12 @@ struct KeyboardAndMouse {
 	
 	bool enterKey;
 	bool enterKeyJustPressed = false; // hack for now
+
+	bool f9Key; // dumps the profiler trace
+	bool f9KeyJustPressed = false;
+
+	bool f10Key; // starts/stops a PVD capture file
+	bool f10KeyJustPressed = false;
 };
 
 
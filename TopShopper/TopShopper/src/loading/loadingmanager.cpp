@@ -4,6 +4,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "rendering/geometry.h"
+#include "utility/profiler.h"
 
 #include <stddef.h>
 #include <string.h>
@@ -1089,7 +1090,7 @@ void LoadingManager::init() {
 }
 
 void LoadingManager::updateSeconds(double variableDeltaTime) {
-
+	PROFILE_SCOPE("LoadingManager::updateSeconds");
 }
 
 
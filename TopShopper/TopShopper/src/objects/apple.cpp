@@ -9,7 +9,7 @@ Apple::Apple(PxRigidDynamic *actor)
 	_actor->userData = this;
 
 	addComponent(ComponentTypes::PICKUP_SCRIPT);
-	std::shared_ptr<PickupScript> pickupScript = std::static_pointer_cast<PickupScript>(getComponent(ComponentTypes::PICKUP_SCRIPT));
+	PickupScript *pickupScript = static_cast<PickupScript*>(getComponent(ComponentTypes::PICKUP_SCRIPT));
 	pickupScript->_points = 10;
 }
 
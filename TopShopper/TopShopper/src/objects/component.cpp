@@ -3,8 +3,12 @@
 #include "shoppingcartplayer.h"
 #include "vehicle/vehicleshoppingcart.h"
 #include "core/broker.h"
+#include "core/componentpools.h"
+#include "core/snapshot.h"
+#include "physics/raycastbatch.h"
 #include <iostream>
 #include <cstdlib>
+#include <cassert>
 
 
 
@@ -16,16 +20,13 @@ Component::Component(Entity *entity, ComponentTypes tag) : _entity(entity), _tag
 
 
 ////////////////////////////
-BehaviourScript::BehaviourScript(Entity *entity, ComponentTypes tag) : Component(entity, tag) {}
+BehaviourScript::BehaviourScript(Entity *entity, ComponentTypes tag, FixedUpdateModes fixedUpdateMode, int frameCallbacks) : Component(entity, tag), _fixedUpdateMode(fixedUpdateMode), _frameCallbacks(frameCallbacks) {}
 
 
 ////////////////////////////
-MysteryBagScript::MysteryBagScript(Entity *entity) : BehaviourScript(entity, ComponentTypes::MYSTERY_BAG_SCRIPT) {}
+MysteryBagScript::MysteryBagScript(Entity *entity) : BehaviourScript(entity, ComponentTypes::MYSTERY_BAG_SCRIPT, FixedUpdateModes::FIXED_UPDATE_NEVER, FrameCallbacks::FRAME_CALLBACKS_NONE) {}
 
-void MysteryBagScript::onSpawn() {
-	_entity->_actor->is<PxRigidDynamic>()->setAngularDamping(0.0f);
-	_entity->_actor->is<PxRigidDynamic>()->setAngularVelocity(PxVec3(1.0f, 5.0f, 1.0f));
-}
+void MysteryBagScript::onSpawn() {} // NOTE: the spin/bob is purely visual (see RenderingManager::getPickupDisplayPose())
 
 void MysteryBagScript::fixedUpdate(double fixedDeltaTime) {}
 void MysteryBagScript::onCollisionEnter(physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity, physx::PxContactPairPoint *contacts, physx::PxU32 nbContacts) {}
@@ -36,7 +37,7 @@ void MysteryBagScript::onTriggerEnter(physx::PxShape *localShape, physx::PxShape
 	
 	if (otherEntity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
 		ShoppingCartPlayer *player = static_cast<ShoppingCartPlayer*>(otherEntity);
-		std::shared_ptr<PlayerScript> playerScript = std::static_pointer_cast<PlayerScript>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *playerScript = static_cast<PlayerScript*>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
 		int rng = rand() % 100; // 0-99
 		if (rng < _cookiePercent) { // IT WAS A COOKIE!...
@@ -63,32 +64,11 @@ void MysteryBagScript::onDestroy() {}
 
 
 ////////////////////////////
-PickupScript::PickupScript(Entity *entity) : BehaviourScript(entity, ComponentTypes::PICKUP_SCRIPT) {}
-
-void PickupScript::onSpawn() {
-	_entity->_actor->is<PxRigidDynamic>()->setAngularDamping(0.0f);
-	_entity->_actor->is<PxRigidDynamic>()->setAngularVelocity(PxVec3(1.0f, 5.0f, 1.0f));
-}
-
-void PickupScript::fixedUpdate(double fixedDeltaTime) {
-	// SAFETY CHECK,,,
-	// if a pickup somehow gets outside the playable space (rough estimate with a bounding box overlapping map), then flag it to be destroyed, so that it doesn't screw up spawn count...
+PickupScript::PickupScript(Entity *entity) : BehaviourScript(entity, ComponentTypes::PICKUP_SCRIPT, FixedUpdateModes::FIXED_UPDATE_NEVER, FrameCallbacks::FRAME_CALLBACKS_NONE) {} // NOTE: fixedUpdate() has nothing left to do, so it isn't even dispatched
 
-	PxVec3 pos = _entity->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
+void PickupScript::onSpawn() {} // NOTE: the spin/bob is purely visual (see RenderingManager::getPickupDisplayPose())
 
-	// rough guess... (DON'T RESIZE MAP AND FORGET TO CHANGE THESE...)
-	float minX = -320.0f;
-	float maxX = 320.0f;
-	float minY = -20.0f;
-	float maxY = 120.0f;
-	float minZ = -320.0f;
-	float maxZ = 320.0f;
-
-	if (pos.x < minX || pos.x > maxX || pos.y < minY || pos.y > maxY || pos.z < minZ || pos.z > maxZ) {
-		_entity->destroy();
-		//std::cout << "PICKUP DESTROYED BY FALLING OUT OF MAP BOUNDING BOX" << std::endl;
-	}
-}
+void PickupScript::fixedUpdate(double fixedDeltaTime) {} // NOTE: falling out of the map is caught by the broadphase now (see CustomBroadPhaseCallback)
 
 void PickupScript::onCollisionEnter(physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity, physx::PxContactPairPoint *contacts, physx::PxU32 nbContacts) {
 	// NOTE: this will only get called for pickups instantiated by a bash collision which will then land on the ground somewhere.
@@ -106,29 +86,20 @@ void PickupScript::onCollisionEnter(physx::PxShape *localShape, physx::PxShape *
 
 
 
-		// make pickup back into a trigger...
-		localShape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, false);
-		localShape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, true);
-
 		// disable gravity
 		_entity->_actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
 
-		// clear all forces and set velocity to 0...
+		// clear all forces and set velocity to 0 (NOTE: has to happen while it's still a non-kinematic body)...
 		PxRigidDynamic *dyn = _entity->_actor->is<PxRigidDynamic>();
 		dyn->clearForce(PxForceMode::eACCELERATION);
 		dyn->clearForce(PxForceMode::eVELOCITY_CHANGE);
-
-		// ~~~~NOTE: these might conflict with future spinning pickups
 		dyn->clearTorque(PxForceMode::eACCELERATION);
 		dyn->clearTorque(PxForceMode::eVELOCITY_CHANGE);
-
 		dyn->setLinearVelocity(PxVec3(0.0f));
-		// ~~~~NOTE: this might conflict with future spinning pickups
-		//dyn->setAngularVelocity(PxVec3(0.0f));
+		dyn->setAngularVelocity(PxVec3(0.0f));
 
-		// reset rotation info to be same as on spawn...
-		dyn->setAngularDamping(0.0f);
-		dyn->setAngularVelocity(PxVec3(1, 5, 1));
+		// make pickup back into a (kinematic) trigger...
+		Broker::getInstance()->getPhysicsManager()->setPickupSolid(_entity, false);
 
 	}
 
@@ -141,8 +112,8 @@ void PickupScript::onTriggerEnter(physx::PxShape *localShape, physx::PxShape *ot
 	
 	if (otherEntity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
 		ShoppingCartPlayer *player = static_cast<ShoppingCartPlayer*>(otherEntity);
-		std::shared_ptr<PlayerScript> playerScript = std::static_pointer_cast<PlayerScript>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
-		playerScript->addPoints(_points); // increase player points by this pickup's value
+		PlayerScript *playerScript = static_cast<PlayerScript*>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		playerScript->addPoints(points()); // increase player points by this pickup's value
 		playerScript->pickedUpItem(_entity->getTag()); // tell player that this type of pickup was picked up
 		_entity->destroy(); // destroy this pickup
 	}
@@ -153,9 +124,24 @@ void PickupScript::update(double variableDeltaTime) {}
 void PickupScript::lateUpdate(double variableDeltaTime) {}
 void PickupScript::onDestroy() {}
 
+int& PickupScript::points() {
+	return _entity->_scene->_componentPools->_pickups._points[getPoolIndex()];
+}
+
+bool PickupScript::isSolid() {
+	return _entity->_scene->_componentPools->_pickups._isSolid[getPoolIndex()] != 0;
+}
+
+uint32_t PickupScript::getPoolIndex() {
+	assert(_entity->_scene != nullptr); // NOTE: pooled state only exists while in a scene
+	uint32_t index = _entity->_scene->_componentPools->getPickupIndex(_entity->_handle);
+	assert(index != INVALID_POOL_INDEX);
+	return index;
+}
+
 
 ////////////////////////////
-PlayerScript::PlayerScript(Entity *entity) : BehaviourScript(entity, ComponentTypes::PLAYER_SCRIPT) {}
+PlayerScript::PlayerScript(Entity *entity) : BehaviourScript(entity, ComponentTypes::PLAYER_SCRIPT, FixedUpdateModes::FIXED_UPDATE_ALWAYS, FrameCallbacks::FRAME_CALLBACKS_NONE) {}
 
 void PlayerScript::onSpawn() {
 	generateNewShoppingList();
@@ -166,12 +152,20 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 	if (player != nullptr) {
 		if (_playerType == PlayerTypes::HUMAN) {
 			Gamepad *pad = Broker::getInstance()->getInputManager()->getGamePad(_inputID);
-			if (pad != nullptr) {
+			InputReplay *inputReplay = Broker::getInstance()->getInputReplay();
+			if (isAIControlled()) {
+				// AUTOPILOT: drives like a bot (rays already run by the batch at the start of the step)
+				navigate(*Broker::getInstance()->getPhysicsManager()->getAIRays());
+			}
+			else if (inputReplay->isPlaying()) {
+				inputReplay->feedRecordedInput(_entity->_scene->_componentPools->getPlayerIndex(_entity->_handle), player->_shoppingCartBase);
+			}
+			else if (pad != nullptr) {
 				PxReal accel = glm::clamp(((pad->rightTrigger + 1) / 2), 0.0f, 1.0f);
 				PxReal reverse = glm::clamp(((pad->leftTrigger + 1) / 2), 0.0f, 1.0f);
 				PxReal handbrake = pad->xButton ? 1.0f : 0.0f;
 				PxReal steer = glm::clamp(pad->leftStickX *-1, -1.0f, 1.0f); // must be negated otherwise steering is backwards
-				bool turboButtonPressed = (_hasHotPotato || pad->bButton);
+				bool turboButtonPressed = (hasHotPotato() || pad->bButton);
 				bool turboTank = PlayerScript::getNBBoosts() > 0;
 				if (turboButtonPressed && !(turboState) && turboTank) {
 					//Broker::getInstance()->getAudioManager()->changeVolumeSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::TURBO_SOUND), 10);
@@ -205,7 +199,7 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 				
 				
 				
-				player->_shoppingCartBase->processRawInputDataController(accel, reverse, handbrake, steer, turboButtonPressed);
+				feedControllerInput(player, accel, reverse, handbrake, steer, turboButtonPressed);
 			}
 			else {
 				if (_inputID == 1) {
@@ -215,7 +209,7 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 					bool handbrakeKeyPressed = kam->leftShiftKey;
 					bool steerLeftKeyPressed = kam->dKey; // NOTE: the steer keys have to be reversed here
 					bool steerRightKeyPressed = kam->aKey;
-					bool turboKeyPressed = (_hasHotPotato || kam->spaceKey);
+					bool turboKeyPressed = (hasHotPotato() || kam->spaceKey);
 					bool turboTank = PlayerScript::getNBBoosts() > 0;
 					if (turboKeyPressed && !(turboState) && turboTank) {
 						Broker::getInstance()->getAudioManager()->playSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::TURBO_SOUND));
@@ -231,14 +225,14 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 					//std::cout << speed << std::endl;
 					Broker::getInstance()->getAudioManager()->playSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::ROLL_SOUND_PLAYER1));
 					Broker::getInstance()->getAudioManager()->changeVolumeSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::ROLL_SOUND_PLAYER1), Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::ROLL_SOUND_PLAYER1)->volume*speed / 60);
-					player->_shoppingCartBase->processRawInputDataKeyboard(accelKeyPressed, reverseKeyPressed, handbrakeKeyPressed, steerLeftKeyPressed, steerRightKeyPressed, turboKeyPressed);
+					feedKeyboardInput(player, accelKeyPressed, reverseKeyPressed, handbrakeKeyPressed, steerLeftKeyPressed, steerRightKeyPressed, turboKeyPressed);
 				}
 			}
 
 			// HUMAN ONLY...
 			// CONSUME FUEL OR RECHARGE FUEL...
 			// NO NEED TO CONSUME/RECHARGE TURBO WHEN YOU HAVE THE HOT POTATO...
-			if (!_hasHotPotato) {
+			if (!hasHotPotato()) {
 				if (player->_shoppingCartBase->IsTurboing()) {
 					player->_shoppingCartBase->consumeTurbo(fixedDeltaTime);
 				}
@@ -249,10 +243,10 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 
 		}
 		else if (_playerType == PlayerTypes::BOT) {
-			std::vector<std::shared_ptr<ShoppingCartPlayer>> carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+			const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 			std::shared_ptr<ShoppingCartPlayer> player1 = nullptr;
 			for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
-				std::shared_ptr<PlayerScript> cartScript = std::static_pointer_cast<PlayerScript>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+				PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 				if (cartScript->_playerType == PlayerTypes::HUMAN && cartScript->_inputID == 1) {
 					player1 = cart;
 					break;
@@ -321,7 +315,7 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 			}
 			
 
-			navigate();
+			navigate(*Broker::getInstance()->getPhysicsManager()->getAIRays()); // NOTE: the rays were already run by the batch at the start of the step
 		}
 		
 
@@ -331,17 +325,17 @@ void PlayerScript::fixedUpdate(double fixedDeltaTime) {
 			player->_shoppingCartBase->tickBashProtectionTimer(fixedDeltaTime);
 		}
 
-		if (_hasHotPotato) {
+		if (hasHotPotato()) {
 			tickHotPotatoTimer(fixedDeltaTime);
 		}
 	}
 }
 
 void PlayerScript::onCollisionEnter(physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity, physx::PxContactPairPoint *contacts, physx::PxU32 nbContacts) {
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player1 = nullptr;
 	for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
-		std::shared_ptr<PlayerScript> cartScript = std::static_pointer_cast<PlayerScript>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 		if (cartScript->_playerType == PlayerTypes::HUMAN && cartScript->_inputID == 1) {
 			player1 = cart;
 			break;
@@ -411,14 +405,13 @@ void PlayerScript::onTriggerEnter(physx::PxShape *localShape, physx::PxShape *ot
 	if (otherEntity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) { // if we hit another cart with our bash trigger volume at the front of the chassis...
 		ShoppingCartPlayer *otherCart = static_cast<ShoppingCartPlayer*>(otherEntity);
 		ShoppingCartPlayer *localCart = static_cast<ShoppingCartPlayer*>(_entity);
-		std::shared_ptr<PlayerScript> otherScript = std::static_pointer_cast<PlayerScript>(otherCart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *otherScript = static_cast<PlayerScript*>(otherCart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
-		if (localCart->_shoppingCartBase->IsTurboing() && !otherCart->_shoppingCartBase->IsBashProtected() && !otherScript->_hasHotPotato) {
+		if (localCart->_shoppingCartBase->IsTurboing() && !otherCart->_shoppingCartBase->IsBashProtected() && !otherScript->hasHotPotato()) {
 			otherScript->bashed();
-			if (_hasHotPotato) {
-				otherScript->giveHotPotato(_hotPotatoTimer);
-				_hasHotPotato = false;
-				_hotPotatoTimer = -1.0;
+			if (hasHotPotato()) {
+				otherScript->giveHotPotato(hotPotatoTimer());
+				setHotPotato(false, -1.0);
 				localCart->_shoppingCartBase->setBashProtected(); // after passing off the hot potato, you get bash protected (prevents immediately receiving hot potato again)
 			}
 		}
@@ -430,40 +423,136 @@ void PlayerScript::update(double variableDeltaTime) {}
 void PlayerScript::lateUpdate(double variableDeltaTime) {}
 void PlayerScript::onDestroy() {}
 
-void PlayerScript::addPoints(int gain) { _points += gain; }
+// POOLED STATE...
+int& PlayerScript::points() {
+	return _entity->_scene->_componentPools->_players._points[getPoolIndex()];
+}
+
+std::array<EntityTypes, 3>& PlayerScript::shoppingListTypes() {
+	return _entity->_scene->_componentPools->_players._shoppingListTypes[getPoolIndex()];
+}
+
+std::array<bool, 3>& PlayerScript::shoppingListFlags() {
+	return _entity->_scene->_componentPools->_players._shoppingListFlags[getPoolIndex()];
+}
+
+bool PlayerScript::hasHotPotato() {
+	return _entity->_scene->_componentPools->_players._hasHotPotato[getPoolIndex()] != 0;
+}
+
+double& PlayerScript::hotPotatoTimer() {
+	return _entity->_scene->_componentPools->_players._hotPotatoTimers[getPoolIndex()];
+}
+
+void PlayerScript::setHotPotato(bool hasHotPotato, double timer) {
+	ComponentPools *pools = _entity->_scene->_componentPools;
+	uint32_t index = getPoolIndex();
+	pools->_players._hasHotPotato[index] = hasHotPotato;
+	pools->_players._hotPotatoTimers[index] = timer;
+}
+
+uint32_t PlayerScript::getPoolIndex() {
+	assert(_entity->_scene != nullptr); // NOTE: pooled state only exists while in a scene
+	uint32_t index = _entity->_scene->_componentPools->getPlayerIndex(_entity->_handle);
+	assert(index != INVALID_POOL_INDEX);
+	return index;
+}
+
+void PlayerScript::addPoints(int gain) { points() += gain; }
 void PlayerScript::subPoints(int loss) {
-	_points -= loss;
-	if (_points < 0) _points = 0; // clamp
+	int &playerPoints = points();
+	playerPoints -= loss;
+	if (playerPoints < 0) playerPoints = 0; // clamp
+}
+
+// NOTE: everything a freshly spawned PlayerScript would have, except _playerType/_inputID (assignPlayer() sets those), keep it in sync with the members
+void PlayerScript::resetState() {
+	// POOLED STATE (same as a new row in ComponentPools::add() + onSpawn())...
+	points() = 0;
+	setHotPotato(false, -1.0);
+	generateNewShoppingList(); // clears the flags too
+
+	// AI...
+	_targets.clear();
+	_firstNavigationRay = 0;
+	_hasSightLineRays = false;
+
+	// INPUT...
+	turboState = false;
+}
+
+bool PlayerScript::isAIControlled() {
+	return _playerType == PlayerTypes::BOT || Broker::getInstance()->_autopilot;
+}
+
+// every raw input goes through these so the input replay sees it (NOTE: bots call these from job workers)...
+void PlayerScript::feedControllerInput(ShoppingCartPlayer *player, PxReal accel, PxReal reverse, PxReal handbrake, PxReal steer, bool turboButtonPressed) {
+	Broker::getInstance()->getInputReplay()->recordControllerInput(_entity->_scene->_componentPools->getPlayerIndex(_entity->_handle), accel, reverse, handbrake, steer, turboButtonPressed);
+	player->_shoppingCartBase->processRawInputDataController(accel, reverse, handbrake, steer, turboButtonPressed);
+}
+
+void PlayerScript::feedKeyboardInput(ShoppingCartPlayer *player, bool accelKeyPressed, bool reverseKeyPressed, bool handbrakeKeyPressed, bool steerLeftKeyPressed, bool steerRightKeyPressed, bool turboKeyPressed) {
+	Broker::getInstance()->getInputReplay()->recordKeyboardInput(_entity->_scene->_componentPools->getPlayerIndex(_entity->_handle), accelKeyPressed, reverseKeyPressed, handbrakeKeyPressed, steerLeftKeyPressed, steerRightKeyPressed, turboKeyPressed);
+	player->_shoppingCartBase->processRawInputDataKeyboard(accelKeyPressed, reverseKeyPressed, handbrakeKeyPressed, steerLeftKeyPressed, steerRightKeyPressed, turboKeyPressed);
+}
+
+void PlayerScript::writeSnapshot(SnapshotWriter &writer) {
+	writer.write(_playerType);
+	writer.write(_inputID);
+	writer.write(points());
+	writer.write(shoppingListTypes());
+	writer.write(shoppingListFlags());
+	writer.write(hasHotPotato());
+	writer.write(hotPotatoTimer());
+	writer.write(turboState);
+}
+
+bool PlayerScript::readSnapshot(SnapshotReader &reader) {
+	bool hasHotPotato = false;
+	double hotPotatoTimer = -1.0;
+
+	reader.read(_playerType);
+	reader.read(_inputID);
+	reader.read(points());
+	reader.read(shoppingListTypes());
+	reader.read(shoppingListFlags());
+	reader.read(hasHotPotato);
+	reader.read(hotPotatoTimer);
+	reader.read(turboState);
+	setHotPotato(hasHotPotato, hotPotatoTimer);
+
+	_targets.clear(); // these hold entity pointers from the future, the AI will give us new ones
+	return !reader.hasFailed();
 }
 
 void PlayerScript::generateNewShoppingList() {
-	_shoppingList_Flags.at(0) = false;
-	_shoppingList_Flags.at(1) = false;
-	_shoppingList_Flags.at(2) = false;
+	shoppingListFlags().at(0) = false;
+	shoppingListFlags().at(1) = false;
+	shoppingListFlags().at(2) = false;
 
 	int rng = rand() % 3;
-	if (rng == 0) _shoppingList_Types.at(0) = EntityTypes::MILK;
-	else if (rng == 1) _shoppingList_Types.at(0) = EntityTypes::WATER;
-	else _shoppingList_Types.at(0) = EntityTypes::COLA;
+	if (rng == 0) shoppingListTypes().at(0) = EntityTypes::MILK;
+	else if (rng == 1) shoppingListTypes().at(0) = EntityTypes::WATER;
+	else shoppingListTypes().at(0) = EntityTypes::COLA;
 
 	rng = rand() % 3;
-	if (rng == 0) _shoppingList_Types.at(1) = EntityTypes::APPLE;
-	else if (rng == 1) _shoppingList_Types.at(1) = EntityTypes::WATERMELON;
-	else _shoppingList_Types.at(1) = EntityTypes::BANANA;
+	if (rng == 0) shoppingListTypes().at(1) = EntityTypes::APPLE;
+	else if (rng == 1) shoppingListTypes().at(1) = EntityTypes::WATERMELON;
+	else shoppingListTypes().at(1) = EntityTypes::BANANA;
 
 	rng = rand() % 3;
-	if (rng == 0) _shoppingList_Types.at(2) = EntityTypes::CARROT;
-	else if (rng == 1) _shoppingList_Types.at(2) = EntityTypes::EGGPLANT;
-	else _shoppingList_Types.at(2) = EntityTypes::BROCCOLI;
+	if (rng == 0) shoppingListTypes().at(2) = EntityTypes::CARROT;
+	else if (rng == 1) shoppingListTypes().at(2) = EntityTypes::EGGPLANT;
+	else shoppingListTypes().at(2) = EntityTypes::BROCCOLI;
 }
 
 
 void PlayerScript::pickedUpItem(EntityTypes pickupType) {
 	// add test audio
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player1 = nullptr;
 	for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
-		std::shared_ptr<PlayerScript> cartScript = std::static_pointer_cast<PlayerScript>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 		if (cartScript->_playerType == PlayerTypes::HUMAN && cartScript->_inputID == 1) {
 			player1 = cart;
 			break;
@@ -500,11 +589,11 @@ void PlayerScript::pickedUpItem(EntityTypes pickupType) {
 		Broker::getInstance()->getAudioManager()->changeDistanceSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::PICKITEM_SOUND), distanceBetween, angle);
 		Broker::getInstance()->getAudioManager()->playSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::PICKITEM_SOUND));
 	for (int i = 0; i < 3; i++) { // loop through shopping list...
-		if (_shoppingList_Types.at(i) == pickupType) { // if we just picked up item on our list...
-			_shoppingList_Flags.at(i) = true; // flag that it has been picked up
+		if (shoppingListTypes().at(i) == pickupType) { // if we just picked up item on our list...
+			shoppingListFlags().at(i) = true; // flag that it has been picked up
 			
 			// now check if all 3 items on list have been collected...
-			for (bool flag : _shoppingList_Flags) {
+			for (bool flag : shoppingListFlags()) {
 				if (!flag) return;
 			}
 			// get here if all 3 are true...
@@ -522,10 +611,10 @@ void PlayerScript::bashed() {
 	bashedCart->_shoppingCartBase->setBashProtected();
 //	Broker::getInstance()->getAudioManager()->playSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::HITWALL_SOUND));
 
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player1 = nullptr;
 	for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
-		std::shared_ptr<PlayerScript> cartScript = std::static_pointer_cast<PlayerScript>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 		if (cartScript->_playerType == PlayerTypes::HUMAN && cartScript->_inputID == 1) {
 			player1 = cart;
 			break;
@@ -567,9 +656,9 @@ void PlayerScript::bashed() {
 
 	std::vector<EntityTypes> lostItems; // can have size 0,1 or 2
 	for (int i = 0; i < 3; i++) {
-		if (_shoppingList_Flags.at(i)) {
-			lostItems.push_back(_shoppingList_Types.at(i));
-			_shoppingList_Flags.at(i) = false;
+		if (shoppingListFlags().at(i)) {
+			lostItems.push_back(shoppingListTypes().at(i));
+			shoppingListFlags().at(i) = false;
 		}
 	}
 	
@@ -591,13 +680,9 @@ void PlayerScript::bashed() {
 		// apply an impulse in xz-plane at a different (maybe random) rotation (0, 90, 180, 270) - can keep cycling through this
 
 		PxRigidDynamic *spawnedItemDyn = spawnedItem->_actor->is<PxRigidDynamic>();
-		PxShape* shapeBuffer[1];
-		spawnedItemDyn->getShapes(shapeBuffer, 1);
-		PxShape* spawnedItemShape = shapeBuffer[0];
 
 		// make it solid...
-		spawnedItemShape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, false);
-		spawnedItemShape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, true);
+		Broker::getInstance()->getPhysicsManager()->setPickupSolid(spawnedItem.get(), true);
 		
 		// enable gravity
 		spawnedItemDyn->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, false);
@@ -645,13 +730,9 @@ void PlayerScript::coinExplosion() {
 		// apply an impulse in xz-plane at a different (maybe random) rotation (0, 90, 180, 270) - can keep cycling through this
 
 		PxRigidDynamic *spawnedItemDyn = spawnedItem->_actor->is<PxRigidDynamic>();
-		PxShape* shapeBuffer[1];
-		spawnedItemDyn->getShapes(shapeBuffer, 1);
-		PxShape* spawnedItemShape = shapeBuffer[0];
 
 		// make it solid...
-		spawnedItemShape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, false);
-		spawnedItemShape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, true);
+		Broker::getInstance()->getPhysicsManager()->setPickupSolid(spawnedItem.get(), true);
 
 		// enable gravity
 		spawnedItemDyn->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, false);
@@ -667,9 +748,68 @@ void PlayerScript::coinExplosion() {
 
 
 
+// every bot's rays for the step, in the order they get queued...
+enum NavigationRays {
+	NAVIGATION_RAY_FAR_LEFT,
+	NAVIGATION_RAY_MID_LEFT,
+	NAVIGATION_RAY_CENTER,
+	NAVIGATION_RAY_MID_RIGHT,
+	NAVIGATION_RAY_FAR_RIGHT,
+	NAVIGATION_RAY_SIGHT_LEFT, // only queued when the bot has a target entity
+	NAVIGATION_RAY_SIGHT_CENTER,
+	NAVIGATION_RAY_SIGHT_RIGHT
+};
+
+
 // NOTE: the bots should be raycasting every single frame to prevent slowing down and getting stuck
+// NOTE: only queues the rays, the physics manager executes the batch for every bot at once before the fixedUpdate() pass (which calls navigate())
+void PlayerScript::queueNavigationRays(RaycastBatch &rays) {
+
+	ShoppingCartPlayer *player = static_cast<ShoppingCartPlayer*>(_entity);
+	PxTransform transform = player->_actor->is<PxRigidDynamic>()->getGlobalPose();
+	PxVec3 pos = transform.p;
+	PxQuat rot = transform.q;
+
+	PxVec3 forward(0.0f, 0.0f, 1.0f);
+	forward = rot.rotate(forward);
+
+	// 5 raycasts (FarLeft, MidLeft, Center, MidRight, FarRight)
+	// the middle 3 use the normalized forward vector as their unit dir
+	PxVec3 farLeftOrigin = rot.rotate(PxVec3(1.75f, 0.0f, 2.7f)) + pos;
+	PxVec3 midLeftOrigin = rot.rotate(PxVec3(1.75f, 0.0f, 2.7f)) + pos;
+	PxVec3 centerOrigin = rot.rotate(PxVec3(0.0f, 0.0f, 2.7f)) + pos;
+	PxVec3 midRightOrigin = rot.rotate(PxVec3(-1.75f, 0.0f, 2.7f)) + pos;
+	PxVec3 farRightOrigin = rot.rotate(PxVec3(-1.75f, 0.0f, 2.7f)) + pos;
+
+	PxVec3 farLeftUnitDir = (rot.rotate(PxVec3(1.0, 0.0, 1.0))).getNormalized();
+	PxVec3 midLeftUnitDir = forward.getNormalized();
+	PxVec3 centerUnitDir = forward.getNormalized();
+	PxVec3 midRightUnitDir = forward.getNormalized();
+	PxVec3 farRightUnitDir = (rot.rotate(PxVec3(-1.0, 0.0, 1.0))).getNormalized();
+
+	const PxReal feelerDistance = 20.0f;
+
+	_firstNavigationRay = rays.addRay(farLeftOrigin, farLeftUnitDir, feelerDistance);
+	rays.addRay(midLeftOrigin, midLeftUnitDir, feelerDistance);
+	rays.addRay(centerOrigin, centerUnitDir, feelerDistance);
+	rays.addRay(midRightOrigin, midRightUnitDir, feelerDistance);
+	rays.addRay(farRightOrigin, farRightUnitDir, feelerDistance);
+
+	// 3 sight line raycasts from the middle 3 origins towards the target...
+	_hasSightLineRays = _targets.size() > 0 && _targets.at(0)._targetEntity != nullptr;
+	if (_hasSightLineRays) {
+		const PxReal sightLineDistance = 25.0f;
+
+		rays.addRay(midLeftOrigin, (_targets.at(0)._pos - midLeftOrigin).getNormalized(), sightLineDistance);
+		rays.addRay(centerOrigin, (_targets.at(0)._pos - centerOrigin).getNormalized(), sightLineDistance);
+		rays.addRay(midRightOrigin, (_targets.at(0)._pos - midRightOrigin).getNormalized(), sightLineDistance);
+	}
+}
+
+
+
 // TODO: test if ground plane still have a normal of ~ 0,1,0. if not this could be causing invalid raycasts with ground plane
-void PlayerScript::navigate() {
+void PlayerScript::navigate(RaycastBatch &rays) {
 
 	ShoppingCartPlayer *player = dynamic_cast<ShoppingCartPlayer*>(_entity);
 	PxTransform transform = player->_actor->is<PxRigidDynamic>()->getGlobalPose();
@@ -720,67 +860,31 @@ void PlayerScript::navigate() {
 	}
 
 	
-	// 5 raycasts (FarLeft, MidLeft, Center, MidRight, FarRight)
-
-	// 1. find the forward vector...
-
-	// already have it above...
-
-	// normalize the forward vector (this will be the unit dir for the middle 3 raycasts
-
-
-	PxVec3 farLeftOrigin = rot.rotate(PxVec3(1.75f, 0.0f, 2.7f)) + pos;
-	PxVec3 midLeftOrigin = rot.rotate(PxVec3(1.75f, 0.0f, 2.7f)) + pos;
-	PxVec3 centerOrigin = rot.rotate(PxVec3(0.0f, 0.0f, 2.7f)) + pos;
-	PxVec3 midRightOrigin = rot.rotate(PxVec3(-1.75f, 0.0f, 2.7f)) + pos;
-	PxVec3 farRightOrigin = rot.rotate(PxVec3(-1.75f, 0.0f, 2.7f)) + pos;
-
-	PxVec3 farLeftUnitDir = (rot.rotate(PxVec3(1.0, 0.0, 1.0))).getNormalized();
-	PxVec3 midLeftUnitDir = forward.getNormalized();
-	PxVec3 centerUnitDir = forward.getNormalized();
-	PxVec3 midRightUnitDir = forward.getNormalized();
-	PxVec3 farRightUnitDir = (rot.rotate(PxVec3(-1.0, 0.0, 1.0))).getNormalized();
-
-	PxReal farLeftDistance = 20.0f;
-	PxReal midLeftDistance = 20.0f;
-	PxReal centerDistance = 20.0f;
-	PxReal midRightDistance = 20.0f;
-	PxReal farRightDistance = 20.0f;
+	// 5 raycasts (FarLeft, MidLeft, Center, MidRight, FarRight), already run by the batch (see queueNavigationRays())...
 
-	PxHitBuffer<PxRaycastHit> farLeftHit;
-	PxHitBuffer<PxRaycastHit> midLeftHit;
-	PxHitBuffer<PxRaycastHit> centerHit;
-	PxHitBuffer<PxRaycastHit> midRightHit;
-	PxHitBuffer<PxRaycastHit> farRightHit;
+	const PxRaycastQueryResult &farLeftHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_FAR_LEFT);
+	const PxRaycastQueryResult &midLeftHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_MID_LEFT);
+	const PxRaycastQueryResult &centerHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_CENTER);
+	const PxRaycastQueryResult &midRightHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_MID_RIGHT);
+	const PxRaycastQueryResult &farRightHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_FAR_RIGHT);
 
-	bool farLeftStatus = Broker::getInstance()->getPhysicsManager()->raycast(farLeftOrigin, farLeftUnitDir, farLeftDistance, farLeftHit);
-	bool midLeftStatus = Broker::getInstance()->getPhysicsManager()->raycast(midLeftOrigin, midLeftUnitDir, midLeftDistance, midLeftHit);
-	bool centerStatus = Broker::getInstance()->getPhysicsManager()->raycast(centerOrigin, centerUnitDir, centerDistance, centerHit);
-	bool midRightStatus = Broker::getInstance()->getPhysicsManager()->raycast(midRightOrigin, midRightUnitDir, midRightDistance, midRightHit);
-	bool farRightStatus = Broker::getInstance()->getPhysicsManager()->raycast(farRightOrigin, farRightUnitDir, farRightDistance, farRightHit);
+	// NOTE: every hit is blocking, so hasBlock = the old raycast() status
+	bool farLeftStatus = farLeftHit.hasBlock;
+	bool midLeftStatus = midLeftHit.hasBlock;
+	bool centerStatus = centerHit.hasBlock;
+	bool midRightStatus = midRightHit.hasBlock;
+	bool farRightStatus = farRightHit.hasBlock;
 
 
 	bool sightLineToTarget = false;
-	if (_targets.size() > 0 && _targets.at(0)._targetEntity != nullptr) {
-		PxVec3 lOrigin = midLeftOrigin;
-		PxVec3 cOrigin = centerOrigin;
-		PxVec3 rOrigin = midRightOrigin;
-
-		PxVec3 lUnitDir = (_targets.at(0)._pos - lOrigin).getNormalized();
-		PxVec3 cUnitDir = (_targets.at(0)._pos - cOrigin).getNormalized();
-		PxVec3 rUnitDir = (_targets.at(0)._pos - rOrigin).getNormalized();
-
-		PxReal lDistance = 25.0f;
-		PxReal cDistance = 25.0f;
-		PxReal rDistance = 25.0f;
-
-		PxHitBuffer<PxRaycastHit> lHit;
-		PxHitBuffer<PxRaycastHit> cHit;
-		PxHitBuffer<PxRaycastHit> rHit;
+	if (_hasSightLineRays && _targets.size() > 0 && _targets.at(0)._targetEntity != nullptr) {
+		const PxRaycastQueryResult &lHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_SIGHT_LEFT);
+		const PxRaycastQueryResult &cHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_SIGHT_CENTER);
+		const PxRaycastQueryResult &rHit = rays.getResult(_firstNavigationRay + NAVIGATION_RAY_SIGHT_RIGHT);
 
-		bool lStatus = Broker::getInstance()->getPhysicsManager()->raycast(lOrigin, lUnitDir, lDistance, lHit);
-		bool cStatus = Broker::getInstance()->getPhysicsManager()->raycast(cOrigin, cUnitDir, cDistance, cHit);
-		bool rStatus = Broker::getInstance()->getPhysicsManager()->raycast(rOrigin, rUnitDir, rDistance, rHit);
+		bool lStatus = lHit.hasBlock;
+		bool cStatus = cHit.hasBlock;
+		bool rStatus = rHit.hasBlock;
 
 		if (lStatus || cStatus || rStatus) {
 			sightLineToTarget = true; // assume we have a clear path to target entity...
@@ -850,9 +954,9 @@ void PlayerScript::navigate() {
 						// supress raycasts with another cart that has the same target as you...
 						// also supress raycasts if you have hot potato and hit cart is not bash protected...
 						ShoppingCartPlayer *hitPlayer = dynamic_cast<ShoppingCartPlayer*>(entityHit);
-						std::shared_ptr<PlayerScript> hitPlayerScript = std::static_pointer_cast<PlayerScript>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
+						PlayerScript *hitPlayerScript = static_cast<PlayerScript*>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
-						if (_hasHotPotato) {
+						if (hasHotPotato()) {
 							if (hitPlayer->_shoppingCartBase->IsBashProtected()) { // ~~~~~~~~~~~~~~~~~~~~~~NOTE: this is probably irrelevant now
 								turnDir += 1;
 								redirected = true;
@@ -905,9 +1009,9 @@ void PlayerScript::navigate() {
 						// supress raycasts with another cart that has the same target as you...
 						// also supress raycasts if you have hot potato and hit cart is not bash protected...
 						ShoppingCartPlayer *hitPlayer = dynamic_cast<ShoppingCartPlayer*>(entityHit);
-						std::shared_ptr<PlayerScript> hitPlayerScript = std::static_pointer_cast<PlayerScript>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
+						PlayerScript *hitPlayerScript = static_cast<PlayerScript*>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
-						if (_hasHotPotato) {
+						if (hasHotPotato()) {
 							if (hitPlayer->_shoppingCartBase->IsBashProtected()) {
 								turnDir += 2;
 								redirected = true;
@@ -960,9 +1064,9 @@ void PlayerScript::navigate() {
 						// supress raycasts with another cart that has the same target as you...
 						// also supress raycasts if you have hot potato and hit cart is not bash protected...
 						ShoppingCartPlayer *hitPlayer = dynamic_cast<ShoppingCartPlayer*>(entityHit);
-						std::shared_ptr<PlayerScript> hitPlayerScript = std::static_pointer_cast<PlayerScript>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
+						PlayerScript *hitPlayerScript = static_cast<PlayerScript*>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
-						if (_hasHotPotato) {
+						if (hasHotPotato()) {
 							if (hitPlayer->_shoppingCartBase->IsBashProtected()) {
 								turnDir -= 2;
 								redirected = true;
@@ -1014,9 +1118,9 @@ void PlayerScript::navigate() {
 						// supress raycasts with another cart that has the same target as you...
 						// also supress raycasts if you have hot potato and hit cart is not bash protected...
 						ShoppingCartPlayer *hitPlayer = dynamic_cast<ShoppingCartPlayer*>(entityHit);
-						std::shared_ptr<PlayerScript> hitPlayerScript = std::static_pointer_cast<PlayerScript>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
+						PlayerScript *hitPlayerScript = static_cast<PlayerScript*>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
-						if (_hasHotPotato) {
+						if (hasHotPotato()) {
 							if (hitPlayer->_shoppingCartBase->IsBashProtected()) {
 								turnDir -= 1;
 								redirected = true;
@@ -1073,9 +1177,9 @@ void PlayerScript::navigate() {
 							// supress raycasts with another cart that has the same target as you...
 							// also supress raycasts if you have hot potato and hit cart is not bash protected...
 							ShoppingCartPlayer *hitPlayer = dynamic_cast<ShoppingCartPlayer*>(entityHit);
-							std::shared_ptr<PlayerScript> hitPlayerScript = std::static_pointer_cast<PlayerScript>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
+							PlayerScript *hitPlayerScript = static_cast<PlayerScript*>(hitPlayer->getComponent(ComponentTypes::PLAYER_SCRIPT));
 
-							if (_hasHotPotato) {
+							if (hasHotPotato()) {
 								if (hitPlayer->_shoppingCartBase->IsBashProtected()) {
 									turnDir = 3;
 									redirected = true;
@@ -1135,9 +1239,9 @@ void PlayerScript::navigate() {
 				break;
 			}
 
-			bool turboButtonPressed = (_hasHotPotato || forcedTurbo);
+			bool turboButtonPressed = (hasHotPotato() || forcedTurbo);
 
-			player->_shoppingCartBase->processRawInputDataController(accel, reverse, handbrake, steer, turboButtonPressed);
+			feedControllerInput(player, accel, reverse, handbrake, steer, turboButtonPressed);
 		}
 
 	}
@@ -1187,17 +1291,16 @@ void PlayerScript::navigate() {
 */
 
 
-		bool turboButtonPressed = (_hasHotPotato || forcedTurbo);
+		bool turboButtonPressed = (hasHotPotato() || forcedTurbo);
 		
 
-		player->_shoppingCartBase->processRawInputDataController(accel, reverse, handbrake, steer, turboButtonPressed);
+		feedControllerInput(player, accel, reverse, handbrake, steer, turboButtonPressed);
 	}
 }
 
 
 void PlayerScript::giveHotPotato(double remainingDuration) {
-	_hasHotPotato = true;
-	_hotPotatoTimer = remainingDuration;
+	setHotPotato(true, remainingDuration);
 	// give max turbo to hot potato recipient...
 	ShoppingCartPlayer *player = dynamic_cast<ShoppingCartPlayer*>(_entity);
 	player->_shoppingCartBase->_turboFuel = 4.0f;
@@ -1205,10 +1308,10 @@ void PlayerScript::giveHotPotato(double remainingDuration) {
 }
 
 void PlayerScript::tickHotPotatoTimer(double fixedDeltaTime) {
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player1 = nullptr;
 	for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
-		std::shared_ptr<PlayerScript> cartScript = std::static_pointer_cast<PlayerScript>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 		if (cartScript->_playerType == PlayerTypes::HUMAN && cartScript->_inputID == 1) {
 			player1 = cart;
 			break;
@@ -1243,24 +1346,23 @@ void PlayerScript::tickHotPotatoTimer(double fixedDeltaTime) {
 	if (!(_playerType == PlayerTypes::HUMAN))
 		Broker::getInstance()->getAudioManager()->changeDistanceSFX(Broker::getInstance()->getAudioManager()->getSoundEffect(SoundEffectTypes::TICKING_SOUND), distanceBetween, angle);
 
-	_hotPotatoTimer -= fixedDeltaTime;
-	if (_hotPotatoTimer <= 0.0) {
+	hotPotatoTimer() -= fixedDeltaTime;
+	if (hotPotatoTimer() <= 0.0) {
 		explodeHotPotato();
 	}
 }
 
 void PlayerScript::explodeHotPotato() {
-	_hasHotPotato = false;
-	_hotPotatoTimer = -1.0;
+	setHotPotato(false, -1.0);
 	const int hotPotatoLostPoints = 100;
 	subPoints(hotPotatoLostPoints);
 	bashed();
 	//TODO: UI indicator that you exploded/points were lost???
 
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &carts = Broker::getInstance()->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player1 = nullptr;
 	for (const std::shared_ptr<ShoppingCartPlayer> &cart : carts) {
-		std::shared_ptr<PlayerScript> cartScript = std::static_pointer_cast<PlayerScript>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
 		if (cartScript->_playerType == PlayerTypes::HUMAN && cartScript->_inputID == 1) {
 			player1 = cart;
 			break;
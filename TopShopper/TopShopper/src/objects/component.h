@@ -2,17 +2,23 @@
 #define COMPONENT_H_
 
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 #include "utility/utility.h"
 
 
 class Entity;
+class ShoppingCartPlayer;
+class SnapshotWriter;
+class SnapshotReader;
+class RaycastBatch;
 enum EntityTypes;
 namespace physx {
 	class PxShape;
 	struct PxContactPairPoint;
 	typedef uint32_t PxU32;
+	typedef float PxReal;
 };
 
 
@@ -40,13 +46,30 @@ struct Component {
 
 // SCRIPTS ...
 
+// which steps a script's fixedUpdate() gets called on (see ComponentPools::_fixedUpdates)...
+enum FixedUpdateModes {
+	FIXED_UPDATE_NEVER,
+	FIXED_UPDATE_ALWAYS
+};
+
+// which per-frame callbacks a script actually implements (bit flags), the others never get called (see ComponentPools::_updates/_lateUpdates)...
+enum FrameCallbacks {
+	FRAME_CALLBACKS_NONE = 0,
+	FRAME_CALLBACK_UPDATE = 1 << 0,
+	FRAME_CALLBACK_LATE_UPDATE = 1 << 1
+};
+
+
 // SHOULD NOT BE INSTANTIATED DIRECTLY
 struct BehaviourScript : Component {
-	BehaviourScript(Entity *entity, ComponentTypes tag);
+	BehaviourScript(Entity *entity, ComponentTypes tag, FixedUpdateModes fixedUpdateMode, int frameCallbacks);
+
+	const FixedUpdateModes _fixedUpdateMode;
+	const int _frameCallbacks; // FrameCallbacks flags
 
 	// EXECUTION ORDER OF THESE EVENT CALLBACKS...
 	virtual void onSpawn()=0; // should be called only ONCE immediately after instantiation
-	virtual void fixedUpdate(double fixedDeltaTime)=0; // should be called EVERY PHYSICS UPDATE before fetchresults()
+	virtual void fixedUpdate(double fixedDeltaTime)=0; // called EVERY PHYSICS UPDATE before simulate() (as long as _fixedUpdateMode wants it)
 	
 	// NOTE: the order of these 5 is unknown, but they all happen between fixedUpdate() and update(), during fetchResults()
 	virtual void onCollisionEnter(physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity, physx::PxContactPairPoint *contacts, physx::PxU32 nbContacts)=0;
@@ -54,8 +77,8 @@ struct BehaviourScript : Component {
 	virtual void onTriggerEnter(physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity)=0;
 	virtual void onTriggerExit(physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity)=0;
 	
-	virtual void update(double variableDeltaTime)=0; // should be called ONCE PER FRAME (inside AIManager's update)
-	virtual void lateUpdate(double variableDeltaTime)=0; // should be called ONCE PER FRAME (inside RenderingManager's update)
+	virtual void update(double variableDeltaTime)=0; // should be called ONCE PER FRAME (inside AIManager's update, only with FRAME_CALLBACK_UPDATE)
+	virtual void lateUpdate(double variableDeltaTime)=0; // should be called ONCE PER FRAME (inside RenderingManager's update, only with FRAME_CALLBACK_LATE_UPDATE)
 	virtual void onDestroy()=0; // should be called ONCE immediately before frame ends (after all other updates)
 };
 
@@ -102,7 +125,13 @@ struct PickupScript : BehaviourScript {
 
 	// SPECIFICS...
 
-	int _points = 0; // value of this pickup
+	int _points = 0; // prefab value of this pickup (copied into the scene's pickup pool when spawned)
+
+	int& points(); // pooled value (see core/componentpools.h)
+	bool isSolid(); // pooled, only PhysicsManager::setPickupSolid() changes it
+
+private:
+	uint32_t getPoolIndex(); // this pickup's row (asserts that it has one)
 };
 
 
@@ -135,16 +164,27 @@ struct PlayerScript : BehaviourScript {
 	// NEW DEFINITION: AI1.id = -1, AI2.id = -2, etc., HUMAN1.id = 1, HUMAN2.id =2, etc. DEFAULT ID = 0 (UNUSED)
 	int _inputID = 0;
 
-	int _points = 0; // amount of points this player has
-	// NOTE: maybe init this array with a special NONE enum value?
-	std::array<EntityTypes, 3> _shoppingList_Types; // e.g. MILK, APPLE, CARROT
-	std::array<bool, 3> _shoppingList_Flags; // e.g. MILK=false, APPLE=true, CARROT=true
+	// POOLED STATE...
+	// stored in the scene's ComponentPools (SoA), these just return this player's row
+	// NOTE: only valid while the entity is in a scene (from addEntity() until removeEntity())
+	int& points(); // amount of points this player has
+	std::array<EntityTypes, 3>& shoppingListTypes(); // e.g. MILK, APPLE, CARROT
+	std::array<bool, 3>& shoppingListFlags(); // e.g. MILK=false, APPLE=true, CARROT=true
+	bool hasHotPotato();
+	double& hotPotatoTimer();
+	void setHotPotato(bool hasHotPotato, double timer);
 
 	void addPoints(int gain);
 	void subPoints(int loss);
 
 	void generateNewShoppingList();
 
+	void resetState(); // WARM RESTART: back to start-of-match state (0 points, no hot potato, new list + flags, no AI targets/rays, turbo button released)
+
+	// SNAPSHOTS: player type/ID + pooled state (AI targets are dropped on restore and get picked again on the next AI update)
+	void writeSnapshot(SnapshotWriter &writer);
+	bool readSnapshot(SnapshotReader &reader);
+
 	void pickedUpItem(EntityTypes pickupType);
 
 	static const int SHOPPING_LIST_COMPLETED_POINTS = 100;
@@ -156,17 +196,27 @@ struct PlayerScript : BehaviourScript {
 
 	// AI STUFF...
 	std::vector<ItemLocation> _targets; // starts empty
-	void navigate();
+	void queueNavigationRays(RaycastBatch &rays); // feelers + target sight lines, run for every bot at once (see physics/raycastbatch.h)
+	void navigate(RaycastBatch &rays); // from fixedUpdate(), after the batch has been executed
+	physx::PxU32 _firstNavigationRay = 0; // this bot's rays in the batch (NAVIGATION_RAY_* order, see component.cpp)
+	bool _hasSightLineRays = false;
+	static const int MAX_NAVIGATION_RAYS = 8; // 5 feelers + 3 sight lines
+	bool isAIControlled(); // bots, and humans too while the broker's autopilot is on
+
+	// INPUT (records into the input replay, then feeds the vehicle)...
+	void feedControllerInput(ShoppingCartPlayer *player, physx::PxReal accel, physx::PxReal reverse, physx::PxReal handbrake, physx::PxReal steer, bool turboButtonPressed);
+	void feedKeyboardInput(ShoppingCartPlayer *player, bool accelKeyPressed, bool reverseKeyPressed, bool handbrakeKeyPressed, bool steerLeftKeyPressed, bool steerRightKeyPressed, bool turboKeyPressed);
 
 
 
-	bool _hasHotPotato = false;
-	double _hotPotatoTimer = -1.0;
 	void giveHotPotato(double remainingDuration);
 	void tickHotPotatoTimer(double fixedDeltaTime);
 	void explodeHotPotato();
 	
 	int getNBBoosts();
+
+private:
+	uint32_t getPoolIndex(); // this player's row (asserts that it has one)
 };
 
 
@@ -1,4 +1,5 @@
 #include "entity.h"
+#include "PxRigidActor.h"
 
 using namespace physx;
 
@@ -47,22 +48,53 @@ void Entity::addComponent(ComponentTypes componentType) {
 }
 
 
-std::shared_ptr<Component> Entity::getComponent(ComponentTypes componentType) {
+Component* Entity::getComponent(ComponentTypes componentType) {
 	// input safety check...
 	if (componentType == ComponentTypes::NUMBER_OF_COMPONENT_TYPES) return nullptr; // NONSENSE!
 
 	int index = (componentType == ComponentTypes::MYSTERY_BAG_SCRIPT || componentType == ComponentTypes::PICKUP_SCRIPT || componentType == ComponentTypes::PLAYER_SCRIPT) ? ComponentTypes::BEHAVIOUR_SCRIPT : componentType;
+	Component *comp = _components[index].get();
 
 	if (componentType == ComponentTypes::MYSTERY_BAG_SCRIPT || componentType == ComponentTypes::PICKUP_SCRIPT || componentType == ComponentTypes::PLAYER_SCRIPT) {
-		return (_components.at(index) != nullptr && _components.at(index)->_tag == componentType ? _components.at(index) : nullptr);
+		return (comp != nullptr && comp->_tag == componentType ? comp : nullptr);
 	}
 	else {
-		return _components.at(index); // either a shared_ptr (if attached) or nullptr (if not attached)
+		return comp; // either the component (if attached) or nullptr (if not attached)
 	}
 
 }
 
 
 void Entity::destroy() {
+	if (_destroyFlag) return; // already queued
 	_destroyFlag = true;
+	if (_scene != nullptr) _scene->queueDestroy(_handle);
+}
+
+
+void Entity::resetPoseHistory() {
+	if (_actor == nullptr) return;
+	_currPose = _actor->is<PxRigidActor>()->getGlobalPose();
+	_prevPose = _currPose;
+}
+
+
+void Entity::snapshotPose() {
+	if (_actor == nullptr) return;
+	_prevPose = _currPose;
+	_currPose = _actor->is<PxRigidActor>()->getGlobalPose();
+}
+
+
+PxTransform Entity::getInterpolatedPose(float alpha) {
+	alpha = glm::clamp(alpha, 0.0f, 1.0f);
+
+	PxVec3 pos = _prevPose.p + (_currPose.p - _prevPose.p) * alpha;
+
+	// NLERP (take the shortest arc, since q and -q are the same rotation)...
+	PxQuat prevRot = _prevPose.q;
+	if (prevRot.dot(_currPose.q) < 0.0f) prevRot = -prevRot;
+	PxQuat rot = (prevRot * (1.0f - alpha) + _currPose.q * alpha).getNormalized();
+
+	return PxTransform(pos, rot);
 }
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
+#include <foundation/PxTransform.h>
+#include "core/gamescene.h"
 
 
 namespace physx {
@@ -102,12 +104,26 @@ class Entity {
 		physx::PxActor *_actor = nullptr;
 
 		void addComponent(ComponentTypes componentType); // only adds a component with default values to entity. These values can be overwritten afterwords through getComponent and public field changing or getters/setters
-		std::shared_ptr<Component> getComponent(ComponentTypes componentType);
+		Component* getComponent(ComponentTypes componentType); // nullptr if not attached (NOTE: raw pointer, the entity owns its components, so no refcounting per lookup)
+		BehaviourScript* getBehaviourScript() { return static_cast<BehaviourScript*>(_components[ComponentTypes::BEHAVIOUR_SCRIPT].get()); } // whichever script is attached (or nullptr), no refcounting (e.g. collision callbacks)
 
 		EntityTypes getTag() { return _tag; }
 		bool getDestroyFlag() { return _destroyFlag; }
 
-		void destroy();
+		void destroy(); // flags this entity and queues it up for removal at the end of the frame
+		void resetDestroyFlag() { _destroyFlag = false; } // NOTE: only for entities being reused by the pickup pool (physics/pickuppool.h)
+
+		EntityHandle _handle; // set by the scene in addEntity() (null handle if not in a scene)
+		GameScene *_scene = nullptr;
+
+		// RENDER INTERPOLATION...
+		// physics only steps at a fixed rate, so the renderer draws a blend of the last 2 simulated poses instead of the raw actor pose
+		void resetPoseHistory(); // prev = current = actor pose (call on spawn/teleport so it doesn't get smeared across the jump)
+		void snapshotPose(); // shifts current -> previous and reads the new current pose from the actor (call once after every physics step)
+		physx::PxTransform getInterpolatedPose(float alpha); // alpha in [0,1] (0 = previous step, 1 = current step)
+
+		physx::PxTransform _prevPose = physx::PxTransform(physx::PxIdentity);
+		physx::PxTransform _currPose = physx::PxTransform(physx::PxIdentity);
 
 	private:
 		EntityTypes _tag;
@@ -9,7 +9,6 @@ MysteryBag::MysteryBag(PxRigidDynamic *actor)
 	_actor->userData = this;
 
 	addComponent(ComponentTypes::MYSTERY_BAG_SCRIPT);
-	std::shared_ptr<MysteryBagScript> mysteryBagScript = std::static_pointer_cast<MysteryBagScript>(getComponent(ComponentTypes::MYSTERY_BAG_SCRIPT));
 }
 
 
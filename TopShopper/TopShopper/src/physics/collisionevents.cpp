@@ -0,0 +1,61 @@
+#include "collisionevents.h"
+#include <algorithm>
+
+using namespace physx;
+
+
+
+CollisionEventArena::CollisionEventArena(PxU32 collisionCapacity, PxU32 contactPointCapacity) {
+	_contactCollisions.reserve(collisionCapacity);
+	_triggerCollisions.reserve(collisionCapacity);
+	_contactPoints.resize(contactPointCapacity);
+}
+
+
+
+void CollisionEventArena::reset() {
+	_contactCollisions.clear();
+	_triggerCollisions.clear();
+	_nbContactPoints = 0;
+}
+
+
+
+PxU32 CollisionEventArena::copyContacts(const PxContactPair &pair, PxU32 &nbContacts) {
+	// NOTE: always takes at least 1 slot, scripts read contacts[0] without checking nbContacts
+	PxU32 nbSlots = std::max<PxU32>(pair.contactCount, 1);
+	if (_nbContactPoints + nbSlots > _contactPoints.size()) {
+		_contactPoints.resize(std::max<size_t>(_contactPoints.size() * 2, _nbContactPoints + nbSlots)); // only while warming up to the busiest step
+	}
+
+	PxU32 firstContact = _nbContactPoints;
+	nbContacts = pair.contactCount > 0 ? pair.extractContacts(&_contactPoints[firstContact], pair.contactCount) : 0;
+	if (nbContacts == 0) _contactPoints[firstContact] = PxContactPairPoint();
+
+	_nbContactPoints += nbSlots;
+	return firstContact;
+}
+
+
+void CollisionEventArena::addContactCollision(ContactCollision::ContactCollisionTypes collisionType, BehaviourScript *caller, PxShape *localShape, PxShape *otherShape, Entity *otherEntity, PxU32 firstContact, PxU32 nbContacts) {
+	ContactCollision collision;
+	collision._collisionType = collisionType;
+	collision._caller = caller;
+	collision._localShape = localShape;
+	collision._otherShape = otherShape;
+	collision._otherEntity = otherEntity;
+	collision._firstContact = firstContact;
+	collision._nbContacts = nbContacts;
+	_contactCollisions.push_back(collision);
+}
+
+
+void CollisionEventArena::addTriggerCollision(TriggerCollision::TriggerCollisionTypes collisionType, BehaviourScript *caller, PxShape *localShape, PxShape *otherShape, Entity *otherEntity) {
+	TriggerCollision collision;
+	collision._collisionType = collisionType;
+	collision._caller = caller;
+	collision._localShape = localShape;
+	collision._otherShape = otherShape;
+	collision._otherEntity = otherEntity;
+	_triggerCollisions.push_back(collision);
+}
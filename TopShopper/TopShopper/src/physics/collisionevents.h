@@ -0,0 +1,84 @@
+#ifndef COLLISIONEVENTS_H_
+#define COLLISIONEVENTS_H_
+
+#include "PxPhysicsAPI.h"
+#include <vector>
+
+
+class Entity;
+struct BehaviourScript;
+
+
+// DEFINITION:
+// COLLISION EVENT ARENA (1 per program, filled by the simulation event callback during fetchResults(), read back by PhysicsManager::endStep())
+// the PhysX callbacks can't run gameplay code (no scene changes allowed in there), so every event gets recorded here and dispatched to the scripts afterwards:
+//		_contactCollisions / _triggerCollisions	- 1 record per script that should get an onCollision/onTrigger call
+//		_contactPoints							- every recorded contact point, copied out of the PxContactPair (records refer to them by offset)
+// all 3 buffers are linear: reset() just rewinds them at the start of every step, so once they've grown to the busiest step seen nothing gets allocated anymore.
+//
+// NOTE: the records hold raw script/entity pointers, that's safe since entities only ever get removed in the destroy cleanup AFTER dispatch
+// NOTE: contacts pointers from getContacts() are only valid until the next copyContacts() (the buffer can grow), so only ask for them during dispatch
+
+
+struct ContactCollision {
+
+	enum ContactCollisionTypes {
+		ENTER,
+		EXIT
+	};
+
+	ContactCollisionTypes _collisionType;
+	BehaviourScript *_caller = nullptr;
+	physx::PxShape *_localShape = nullptr;
+	physx::PxShape *_otherShape = nullptr;
+	Entity *_otherEntity = nullptr;
+	physx::PxU32 _firstContact = 0; // offset into the arena's contact points
+	physx::PxU32 _nbContacts = 0;
+
+};
+
+
+
+struct TriggerCollision {
+
+	enum TriggerCollisionTypes {
+		ENTER,
+		EXIT
+	};
+
+	TriggerCollisionTypes _collisionType;
+	BehaviourScript *_caller = nullptr;
+	physx::PxShape *_localShape = nullptr;
+	physx::PxShape *_otherShape = nullptr;
+	Entity *_otherEntity = nullptr;
+
+};
+
+
+
+class CollisionEventArena {
+public:
+	CollisionEventArena(physx::PxU32 collisionCapacity, physx::PxU32 contactPointCapacity); // starting sizes (they still grow if a step needs more)
+
+	void reset(); // start of every step, keeps the memory
+
+	// RECORDING (from inside the PhysX callbacks)...
+	physx::PxU32 copyContacts(const physx::PxContactPair &pair, physx::PxU32 &nbContacts); // returns the offset of the pair's first contact point
+	void addContactCollision(ContactCollision::ContactCollisionTypes collisionType, BehaviourScript *caller, physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity, physx::PxU32 firstContact, physx::PxU32 nbContacts);
+	void addTriggerCollision(TriggerCollision::TriggerCollisionTypes collisionType, BehaviourScript *caller, physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity);
+
+	// DISPATCH...
+	const std::vector<ContactCollision>& getContactCollisions() { return _contactCollisions; }
+	const std::vector<TriggerCollision>& getTriggerCollisions() { return _triggerCollisions; }
+	physx::PxContactPairPoint* getContacts(const ContactCollision &collision) { return &_contactPoints[collision._firstContact]; }
+
+private:
+	std::vector<ContactCollision> _contactCollisions; // NOTE: clear() keeps the capacity
+	std::vector<TriggerCollision> _triggerCollisions;
+	std::vector<physx::PxContactPairPoint> _contactPoints; // always sized to its capacity, _nbContactPoints of them are used this step
+	physx::PxU32 _nbContactPoints = 0;
+};
+
+
+
+#endif // COLLISIONEVENTS_H_
@@ -0,0 +1,208 @@
+#include "cookedmeshcache.h"
+#include "extensions/PxCollectionExt.h"
+#include "rendering/geometry.h"
+#include "utility/utility.h"
+#include <iostream>
+
+#define NOMINMAX // PxMin/PxMax...
+#include <Windows.h>
+
+using namespace physx;
+
+
+
+CookedMeshCache::CookedMeshCache(PxPhysics *physics, PxCooking *cooking, LoadingManager *loadingManager)
+	: _physics(physics), _cooking(cooking), _loadingManager(loadingManager)
+{
+	// NOTE: .obj paths have to match the ones in LoadingManager::init()
+	_meshes = {
+		{ GeometryTypes::GROUND_GEO,	"resources/objects/StoreFloor.obj",		"resources/cooked/StoreFloor.pxbin" },
+		{ GeometryTypes::ROOF_GEO,		"resources/objects/StoreRoof.obj",		"resources/cooked/StoreRoof.pxbin" },
+		{ GeometryTypes::OBSTACLE1_GEO,	"resources/objects/BlueWallBot.obj",	"resources/cooked/BlueWallBot.pxbin" },
+		{ GeometryTypes::OBSTACLE2_GEO,	"resources/objects/BlueWallMid.obj",	"resources/cooked/BlueWallMid.pxbin" },
+		{ GeometryTypes::OBSTACLE3_GEO,	"resources/objects/BlueWallTop.obj",	"resources/cooked/BlueWallTop.pxbin" },
+		{ GeometryTypes::OBSTACLE4_GEO,	"resources/objects/GreenWallBot.obj",	"resources/cooked/GreenWallBot.pxbin" },
+		{ GeometryTypes::OBSTACLE5_GEO,	"resources/objects/GreenWallTop.obj",	"resources/cooked/GreenWallTop.pxbin" },
+		{ GeometryTypes::OBSTACLE6_GEO,	"resources/objects/RedWallBot.obj",		"resources/cooked/RedWallBot.pxbin" },
+		{ GeometryTypes::OBSTACLE7_GEO,	"resources/objects/RedWallTop.obj",		"resources/cooked/RedWallTop.pxbin" }
+	};
+
+	_registry = PxSerialization::createSerializationRegistry(*_physics);
+}
+
+
+CookedMeshCache::~CookedMeshCache() {
+	release();
+}
+
+
+
+bool CookedMeshCache::cookAll() {
+	CreateDirectoryA("resources/cooked", NULL); // fails harmlessly if it's already there
+
+	bool isSuccessful = true;
+	for (CachedMesh &mesh : _meshes) {
+		PxTriangleMesh *triMesh = cookTriangleMesh(mesh._type);
+		if (triMesh == nullptr) {
+			std::cout << "ERROR: couldn't cook " << mesh._objPath << std::endl;
+			isSuccessful = false;
+			continue;
+		}
+
+		PxCollection *collection = PxCreateCollection();
+		collection->add(*triMesh, (PxSerialObjectId)(mesh._type + 1)); // 0 is PX_SERIAL_OBJECT_ID_INVALID
+		PxSerialization::complete(*collection, *_registry);
+
+		PxDefaultFileOutputStream file(mesh._blobPath);
+		if (!file.isValid() || !PxSerialization::serializeCollectionToBinary(file, *collection, *_registry)) {
+			std::cout << "ERROR: couldn't write " << mesh._blobPath << std::endl;
+			isSuccessful = false;
+		}
+		else {
+			std::cout << "COOKED: " << mesh._objPath << " -> " << mesh._blobPath << std::endl;
+		}
+
+		collection->release();
+		triMesh->release();
+	}
+
+	return isSuccessful;
+}
+
+
+
+PxTriangleMesh* CookedMeshCache::getTriangleMesh(GeometryTypes type) {
+	CachedMesh *mesh = findMesh(type);
+	if (mesh == nullptr) {
+		// not a static map mesh, nothing to cache...
+		return cookTriangleMesh(type);
+	}
+	if (mesh->_triMesh != nullptr) return mesh->_triMesh;
+
+	if (!isBlobUpToDate(*mesh)) {
+		std::cout << "WARNING: " << mesh->_blobPath << " is missing or older than " << mesh->_objPath << ", cooking at runtime (run with --cook-collision)" << std::endl;
+	}
+	else if (loadBlob(*mesh)) {
+		return mesh->_triMesh;
+	}
+	else {
+		std::cout << "WARNING: couldn't load " << mesh->_blobPath << ", cooking at runtime (run with --cook-collision)" << std::endl;
+	}
+
+	mesh->_triMesh = cookTriangleMesh(type);
+	return mesh->_triMesh;
+}
+
+
+
+void CookedMeshCache::release() {
+	for (CachedMesh &mesh : _meshes) {
+		if (mesh._collection != nullptr) {
+			PxCollectionExt::releaseObjects(*mesh._collection); // the mesh belongs to the collection
+			mesh._collection->release();
+			mesh._collection = nullptr;
+			unmapBlob(mesh);
+		}
+		else if (mesh._triMesh != nullptr) {
+			mesh._triMesh->release();
+		}
+		mesh._triMesh = nullptr;
+	}
+
+	if (_registry != nullptr) {
+		_registry->release();
+		_registry = nullptr;
+	}
+}
+
+
+
+CookedMeshCache::CachedMesh* CookedMeshCache::findMesh(GeometryTypes type) {
+	for (CachedMesh &mesh : _meshes) {
+		if (mesh._type == type) return &mesh;
+	}
+	return nullptr;
+}
+
+
+PxTriangleMesh* CookedMeshCache::cookTriangleMesh(GeometryTypes type) {
+	Geometry *geometry = _loadingManager->getGeometry(type);
+	std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(geometry->verts);
+	const std::vector<PxU32> &indices = geometry->vIndex;
+
+	PxTriangleMeshDesc meshDesc;
+	meshDesc.points.count = verts.size();
+	meshDesc.points.stride = sizeof(PxVec3);
+	meshDesc.points.data = verts.data();
+
+	meshDesc.triangles.count = indices.size() / 3;
+	meshDesc.triangles.stride = 3 * sizeof(PxU32);
+	meshDesc.triangles.data = indices.data();
+
+	PxTriangleMesh *triMesh = nullptr;
+	PxDefaultMemoryOutputStream buf;
+	if (_cooking->cookTriangleMesh(meshDesc, buf)) {
+		PxDefaultMemoryInputData id(buf.getData(), buf.getSize());
+		triMesh = _physics->createTriangleMesh(id);
+	}
+
+	return triMesh;
+}
+
+
+bool CookedMeshCache::loadBlob(CachedMesh &mesh) {
+	// MAP THE FILE (copy-on-write, views are page aligned which covers PhysX's 128 byte alignment)...
+	HANDLE file = CreateFileA(mesh._blobPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	mesh._fileHandle = file;
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (mapping == NULL) {
+		unmapBlob(mesh);
+		return false;
+	}
+	mesh._mappingHandle = mapping;
+
+	mesh._view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if (mesh._view == NULL) {
+		unmapBlob(mesh);
+		return false;
+	}
+
+	// INSERT (no cooking)...
+	mesh._collection = PxSerialization::createCollectionFromBinary(mesh._view, *_registry);
+	if (mesh._collection == nullptr) {
+		unmapBlob(mesh);
+		return false;
+	}
+
+	PxBase *object = mesh._collection->find((PxSerialObjectId)(mesh._type + 1));
+	mesh._triMesh = object != nullptr ? object->is<PxTriangleMesh>() : nullptr;
+	if (mesh._triMesh == nullptr) {
+		PxCollectionExt::releaseObjects(*mesh._collection);
+		mesh._collection->release();
+		mesh._collection = nullptr;
+		unmapBlob(mesh);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool CookedMeshCache::isBlobUpToDate(const CachedMesh &mesh) {
+	WIN32_FILE_ATTRIBUTE_DATA blobData, objData;
+	if (!GetFileAttributesExA(mesh._blobPath, GetFileExInfoStandard, &blobData)) return false;
+	if (!GetFileAttributesExA(mesh._objPath, GetFileExInfoStandard, &objData)) return true; // no source to compare against, trust the blob
+	return CompareFileTime(&objData.ftLastWriteTime, &blobData.ftLastWriteTime) <= 0;
+}
+
+
+void CookedMeshCache::unmapBlob(CachedMesh &mesh) {
+	if (mesh._view != nullptr) UnmapViewOfFile(mesh._view);
+	if (mesh._mappingHandle != nullptr) CloseHandle(mesh._mappingHandle);
+	if (mesh._fileHandle != nullptr) CloseHandle(mesh._fileHandle);
+	mesh._view = nullptr;
+	mesh._mappingHandle = nullptr;
+	mesh._fileHandle = nullptr;
+}
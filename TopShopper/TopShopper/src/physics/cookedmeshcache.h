@@ -0,0 +1,58 @@
+#ifndef COOKEDMESHCACHE_H_
+#define COOKEDMESHCACHE_H_
+
+#include "PxPhysicsAPI.h"
+#include "loading/loadingmanager.h"
+#include <vector>
+
+
+// DEFINITION:
+// COOKED COLLISION MESHES for the static map (ground, roof, obstacles 1-7)
+// cooking those triangle meshes was the biggest stall when a match started, so they get cooked once offline (--cook-collision, which the project's post-build step runs after every build)
+// into PhysX binary serialized collections (resources/cooked/*.pxbin), which get memory mapped at runtime and inserted without cooking.
+// each mesh is loaded the first time a scene asks for it, then kept for the rest of the program (so later matches don't even map the file again).
+//
+// FALLBACK: if a blob is missing, unreadable or older than its source .obj, that mesh gets cooked at runtime like before (and a warning is printed)
+//
+// NOTE: binary collections are platform specific (32 bit windows here) and tied to the PhysX version, so re-run --cook-collision after upgrading PhysX
+// NOTE: PhysX patches pointers inside the blob when it deserializes it, so the file is mapped copy-on-write and has to stay mapped while the mesh is alive
+
+
+class CookedMeshCache {
+public:
+	CookedMeshCache(physx::PxPhysics *physics, physx::PxCooking *cooking, LoadingManager *loadingManager);
+	virtual ~CookedMeshCache();
+
+	bool cookAll(); // offline step, writes every blob (returns false if any failed)
+	physx::PxTriangleMesh* getTriangleMesh(GeometryTypes type); // cached / mapped / cooked as a last resort (nullptr if cooking failed too)
+	void release(); // NOTE: only once no shape references the meshes anymore
+
+private:
+	struct CachedMesh {
+		GeometryTypes _type;
+		const char *_objPath; // source (same path the loading manager reads)
+		const char *_blobPath;
+		physx::PxTriangleMesh *_triMesh = nullptr;
+		physx::PxCollection *_collection = nullptr; // only set if it came from the blob...
+		void *_fileHandle = nullptr;
+		void *_mappingHandle = nullptr;
+		void *_view = nullptr;
+	};
+
+	CachedMesh* findMesh(GeometryTypes type);
+	physx::PxTriangleMesh* cookTriangleMesh(GeometryTypes type);
+	bool loadBlob(CachedMesh &mesh); // false = fall back to cooking
+	bool isBlobUpToDate(const CachedMesh &mesh);
+	void unmapBlob(CachedMesh &mesh);
+
+	physx::PxPhysics *_physics = nullptr;
+	physx::PxCooking *_cooking = nullptr;
+	LoadingManager *_loadingManager = nullptr;
+	physx::PxSerializationRegistry *_registry = nullptr;
+
+	std::vector<CachedMesh> _meshes;
+};
+
+
+
+#endif // COOKEDMESHCACHE_H_
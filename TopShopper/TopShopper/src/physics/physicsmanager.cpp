@@ -38,13 +38,12 @@
 
 
 
-#define PVD_HOST "127.0.0.1" // Set this to the IP address of the system running the PhysX Visual Debugger that you want to connect to. DEFAULT = LOCALHOST
-
-
 #include <ctype.h>
 
 #include "physicsmanager.h"
 #include <iostream>
+#include <algorithm>
+#include <random>
 
 #include "vehicle/PxVehicleUtil.h"
 #include "vehicle/snippetvehiclecommon/SnippetVehicleSceneQuery.h"
@@ -52,8 +51,18 @@
 #include "vehicle/vehicleshoppingcart.h"
 
 #include "utility/utility.h"
+#include "utility/profiler.h"
 
 #include "core/broker.h"
+#include "core/componentpools.h"
+#include "core/snapshot.h"
+#include "core/benchmark.h"
+#include "physics/collisionevents.h"
+#include "physics/cookedmeshcache.h"
+#include "physics/prefabtable.h"
+#include "physics/pickuppool.h"
+#include "physics/pickupgrid.h"
+#include "physics/raycastbatch.h"
 #include "rendering/geometry.h"
 
 
@@ -68,7 +77,7 @@ PxDefaultErrorCallback	gErrorCallback;
 PxFoundation*			gFoundation = NULL;
 PxPhysics*				gPhysics = NULL;
 
-PxDefaultCpuDispatcher*	gDispatcher = NULL;
+JobSystemCpuDispatcher*	gDispatcher = NULL; // PhysX tasks run on the broker's job system
 
 PxCooking*				gCooking = NULL;
 
@@ -76,17 +85,27 @@ PxCooking*				gCooking = NULL;
 PxPvd*                  gPvd = NULL;
 #endif // PVD_ENABLED
 
+// VEHICLE BATCHES...
+// carts get split into batches of VEHICLES_PER_BATCH (in player pool order), every batch has its own batch query + slice of the result buffers
+// so the suspension raycasts and PxVehicleUpdates() of all batches can run concurrently on the job system (see beginStep())
+static const PxU32 VEHICLES_PER_BATCH = 8;
 VehicleSceneQueryData*	gVehicleSceneQueryData = NULL;
-PxBatchQuery*			gBatchQuery = NULL;
+std::vector<PxBatchQuery*> gBatchQueries; // [batch]
+std::vector<PxWheelQueryResult> gWheelQueryResults; // [vehicle * PX_MAX_NB_WHEELS + wheel]
+std::vector<PxVehicleWheelQueryResult> gVehicleQueryResults; // [vehicle]
+std::vector<PxVehicleWheelConcurrentUpdateData> gWheelConcurrentUpdates; // [vehicle * PX_MAX_NB_WHEELS + wheel]
+std::vector<PxVehicleConcurrentUpdateData> gVehicleConcurrentUpdates; // [vehicle] applied to the actors by PxVehiclePostUpdates() once every batch is done
 
 PxVehicleDrivableSurfaceToTireFrictionPairs* gFrictionPairs = NULL;
 
 CustomSimulationEventCallback gSimEventCallback;
+CustomBroadPhaseCallback gBroadPhaseCallback;
 
 
 
-std::vector<ContactCollision> gContactCollisions;
-std::vector<TriggerCollision> gTriggerCollisions;
+CollisionEventArena gCollisionEvents(256, 2048); // every contact/trigger event of the current step (see physics/collisionevents.h)
+std::vector<Entity*> gOutOfBoundsEntities; // filled in by gBroadPhaseCallback during the step, dealt with in endStep()
+std::vector<Entity*> gPickupOverlaps; // scratch for collectPickups() (1 cart at a time)
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -121,6 +140,60 @@ void initFrictionPairs() {
 // COLLISION FILTERING STUFF...
 
 
+// CONTACT REPORT POLICY (passed to the filter shader as its constant block, PhysX copies it when the scene gets created)
+// says which solid-solid pairs a BehaviourScript actually does something with, indexed by [collision flag bit][collision flag bit]:
+//		eNOTIFY_TOUCH_FOUND / eNOTIFY_TOUCH_LOST	- onCollisionEnter / onCollisionExit gets recorded for the pair
+//		eNOTIFY_CONTACT_POINTS						- the script reads the contact points (otherwise onContact() doesn't extract any)
+// every other pair still gets solved, it just never shows up in onContact()
+// NOTE: the cart's chassis + bash shapes are flagged COLLISION_FLAG_WHEEL (vehicleshoppingcart.cpp overwrites chassisSimFilterData), so WHEEL and CHASSIS both mean "cart" in here
+// NOTE: every onCollisionExit() is empty right now, so nothing asks for eNOTIFY_TOUCH_LOST
+static const PxU32 NUMBER_OF_COLLISION_FLAGS = 6;
+
+struct ContactReportPolicy {
+	PxU32 _pairFlags[NUMBER_OF_COLLISION_FLAGS][NUMBER_OF_COLLISION_FLAGS];
+};
+
+ContactReportPolicy gContactReportPolicy;
+
+
+static PxU32 getCollisionFlagIndex(PxU32 collisionFlag) {
+	for (PxU32 i = 0; i < NUMBER_OF_COLLISION_FLAGS; i++) {
+		if (collisionFlag & (1 << i)) return i;
+	}
+	return NUMBER_OF_COLLISION_FLAGS; // not flagged
+}
+
+
+static void setContactReportPolicy(ContactReportPolicy &policy, PxU32 collisionFlag0, PxU32 collisionFlag1, PxPairFlags pairFlags) {
+	PxU32 index0 = getCollisionFlagIndex(collisionFlag0);
+	PxU32 index1 = getCollisionFlagIndex(collisionFlag1);
+	policy._pairFlags[index0][index1] = (PxU32)pairFlags;
+	policy._pairFlags[index1][index0] = (PxU32)pairFlags; // symmetric
+}
+
+
+static void initContactReportPolicy(ContactReportPolicy &policy) {
+	for (PxU32 i = 0; i < NUMBER_OF_COLLISION_FLAGS; i++) {
+		for (PxU32 j = 0; j < NUMBER_OF_COLLISION_FLAGS; j++) {
+			policy._pairFlags[i][j] = 0; // no reports
+		}
+	}
+
+	const PxU32 cartFlags[] = { COLLISION_FLAG_WHEEL, COLLISION_FLAG_CHASSIS };
+	for (PxU32 cartFlag : cartFlags) {
+		// PlayerScript::onCollisionEnter() - knockback off walls/shelves/roof + other carts, pushes along the first contact normal
+		setContactReportPolicy(policy, cartFlag, COLLISION_FLAG_OBSTACLE, PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_CONTACT_POINTS);
+		for (PxU32 otherCartFlag : cartFlags) {
+			setContactReportPolicy(policy, cartFlag, otherCartFlag, PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_CONTACT_POINTS);
+		}
+	}
+
+	// PickupScript::onCollisionEnter() - a solid pickup (knocked out of a bashed cart) turns back into a trigger once it lands, doesn't need the points
+	setContactReportPolicy(policy, COLLISION_FLAG_PICKUP, COLLISION_FLAG_GROUND, PxPairFlag::eNOTIFY_TOUCH_FOUND);
+}
+
+
+
 // the basic usage of the filter shader, and it will ensure that SampleSubmarine::onContact() is called for all interesting pairs.
 // Callback for every collision pair??? (i guess it applies to each shape?)
 // will be called for all pairs of shapes that come near each other -- more precisely: for all pairs of shapes whose axis aligned bounding boxes in world space are found to intersect for the first time. All behavior beyond that is determined by what SampleSubmarineFilterShader() returns.
@@ -129,9 +202,6 @@ PxFilterFlags CustomFilterShader
 	PxFilterObjectAttributes attributes1, PxFilterData filterData1,
 	PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize)
 {
-	PX_UNUSED(constantBlock);
-	PX_UNUSED(constantBlockSize);
-
 	// if these 2 shapes are not flagged as a symmetric collision pair...
 	if ((0 == (filterData0.word0 & filterData1.word1)) || (0 == (filterData1.word0 & filterData0.word1)))
 		return PxFilterFlag::eSUPPRESS; // ignore collision
@@ -141,10 +211,29 @@ PxFilterFlags CustomFilterShader
 	// if either (or both) shape(s) is a trigger...
 	// NOTE: since PhysX 3.5, Trigger-Trigger collisions are deprecated (can still set pairflags here, but the onTrigger callback will be blocked)
 	if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1)) {
+		// resting pickups vs carts come from the pickup grid instead (see PhysicsManager::collectPickups()), so PhysX doesn't even keep the pair around
+		// NOTE: the pickup swaps shapes when it goes solid, which gets the pair filtered again
+		const PxU32 cartFlags = COLLISION_FLAG_WHEEL | COLLISION_FLAG_CHASSIS;
+		if (((filterData0.word0 & COLLISION_FLAG_PICKUP) && (filterData1.word0 & cartFlags)) || ((filterData1.word0 & COLLISION_FLAG_PICKUP) && (filterData0.word0 & cartFlags)))
+			return PxFilterFlag::eKILL;
+
 		pairFlags = PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_TOUCH_LOST | PxPairFlag::eDETECT_DISCRETE_CONTACT;
 	}
 	else { // if both shapes are solid...
-		pairFlags = PxPairFlag::eSOLVE_CONTACT | PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_TOUCH_LOST | PxPairFlag::eNOTIFY_CONTACT_POINTS | PxPairFlag::eDETECT_DISCRETE_CONTACT;
+		pairFlags = PxPairFlag::eSOLVE_CONTACT | PxPairFlag::eDETECT_DISCRETE_CONTACT;
+
+		// only ask for the reports some script is going to use (see gContactReportPolicy)...
+		if (constantBlockSize == sizeof(ContactReportPolicy)) {
+			const ContactReportPolicy *policy = static_cast<const ContactReportPolicy*>(constantBlock);
+			PxU32 index0 = getCollisionFlagIndex(filterData0.word0);
+			PxU32 index1 = getCollisionFlagIndex(filterData1.word0);
+			if (index0 < NUMBER_OF_COLLISION_FLAGS && index1 < NUMBER_OF_COLLISION_FLAGS) {
+				pairFlags |= PxPairFlags((PxU16)policy->_pairFlags[index0][index1]);
+			}
+		}
+		else { // no policy, report everything
+			pairFlags |= PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_TOUCH_LOST | PxPairFlag::eNOTIFY_CONTACT_POINTS;
+		}
 	}
 	return PxFilterFlag::eDEFAULT;
 
@@ -152,6 +241,32 @@ PxFilterFlags CustomFilterShader
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+// BROADPHASE STUFF...
+
+// the playable space (rough box around the store, DON'T RESIZE MAP AND FORGET TO CHANGE THIS...)
+// the MBP broadphase only tracks shapes inside its regions, so anything that falls/flies out of here stops costing broadphase time
+// and gets reported to gBroadPhaseCallback (replaces the per-step bounds check every pickup used to do in PickupScript::fixedUpdate())
+static const PxBounds3 WORLD_BOUNDS(PxVec3(-320.0f, -20.0f, -320.0f), PxVec3(320.0f, 120.0f, 320.0f));
+static const PxU32 BROADPHASE_REGION_SUBDIVISIONS = 4; // 4*4 regions over the xz plane (the PhysX recommended starting point)
+static const PxReal PICKUP_GRID_CELL_SIZE = 20.0f; // 32*32 cells over WORLD_BOUNDS, ~ a cart length (spare change spawns 10 apart)
+
+
+void CustomBroadPhaseCallback::onObjectOutOfBounds(PxShape &shape, PxActor &actor) {
+	// NOTE: not shape.getActor(), that's NULL for shared (prefab) shapes
+	Entity *entity = static_cast<Entity*>(actor.userData);
+	if (entity == nullptr) return;
+
+	// carts have several shapes, only queue the entity once...
+	if (std::find(gOutOfBoundsEntities.begin(), gOutOfBoundsEntities.end(), entity) != gOutOfBoundsEntities.end()) return;
+	gOutOfBoundsEntities.push_back(entity);
+}
+
+
+void CustomBroadPhaseCallback::onObjectOutOfBounds(PxAggregate &aggregate) {} // no aggregates in the scene
+
+
+
 /*
 CALLBACK INFO
 - callback are called from fetchresults() rather than on the simulation thread
@@ -183,64 +298,47 @@ void CustomSimulationEventCallback::onContact(const PxContactPairHeader &pairHea
 
 		// 1. if either/both shapes have been removed from their respective actors or from the scene...
 		if (pairs[i].flags & (PxContactPairFlag::eREMOVED_SHAPE_0 | PxContactPairFlag::eREMOVED_SHAPE_1)) continue;
+		if (pairHeader.flags & (PxContactPairHeaderFlag::eREMOVED_ACTOR_0 | PxContactPairHeaderFlag::eREMOVED_ACTOR_1)) continue;
 
 		PxShape *shape0 = pairs[i].shapes[0];
 		PxShape *shape1 = pairs[i].shapes[1];
 
-		Entity *entity0 = static_cast<Entity*>(shape0->getActor()->userData);
-		Entity *entity1 = static_cast<Entity*>(shape1->getActor()->userData);
+		// NOTE: not shape->getActor(), that's NULL for shared (prefab) shapes
+		Entity *entity0 = static_cast<Entity*>(pairHeader.actors[0]->userData);
+		Entity *entity1 = static_cast<Entity*>(pairHeader.actors[1]->userData);
 
 		// 2. if either/both entities have been flagged to be destroyed...
 		if (entity0->getDestroyFlag() || entity1->getDestroyFlag()) continue;
 
-		// get contact info...
-		const PxU32 BUFFER_SIZE = 64; // at most get 64 contacts
-		PxContactPairPoint contacts[BUFFER_SIZE];
-		PxU32 nbContacts = pairs[i].extractContacts(contacts, BUFFER_SIZE);
+		// NOW RECORD THE PROPER BEHAVIOURSCRIPT METHOD FOR BOTH ENTITIES (dispatched in endStep())...
+		// NOTE: raw script pointers, no refcounting in here
+		ContactCollision::ContactCollisionTypes collisionType;
+		if (pairs[i].flags & PxContactPairFlag::eACTOR_PAIR_HAS_FIRST_TOUCH) {
+			collisionType = ContactCollision::ContactCollisionTypes::ENTER;
+		}
+		else if (pairs[i].flags & PxContactPairFlag::eACTOR_PAIR_LOST_TOUCH) {
+			collisionType = ContactCollision::ContactCollisionTypes::EXIT;
+		}
+		else {
+			continue;
+		}
 
-		// NOW CALLBACK PROPER BEHAVIOURSCRIPT METHOD FOR BOTH ENTITIES...
+		BehaviourScript *entity0Script = entity0->getBehaviourScript();
+		BehaviourScript *entity1Script = entity1->getBehaviourScript();
+		if (entity0Script == nullptr && entity1Script == nullptr) continue;
 
-		if (pairs[i].flags & PxContactPairFlag::eACTOR_PAIR_HAS_FIRST_TOUCH) {
-			// 1. check if entity0 has a BehaviourScript (will be assigned as a childScript)
-			std::shared_ptr<Component> entity0Comp = entity0->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (entity0Comp != nullptr) {
-				std::shared_ptr<BehaviourScript> entity0Script = std::static_pointer_cast<BehaviourScript>(entity0Comp);
-				// 2. if so call onCollisionEnter(PxShape* localShape = shape0, PxShape* otherShape = shape1, collision stuff)
-				//entity0Script->onCollisionEnter(shape0, shape1, entity1, contacts, nbContacts);
-				ContactCollision collision(ContactCollision::ContactCollisionTypes::ENTER, entity0Script, shape0, shape1, entity1, contacts, nbContacts);
-				gContactCollisions.push_back(collision);
-			}
+		// copy the contact points into the arena (both scripts share them)...
+		PxU32 nbContacts = 0;
+		PxU32 firstContact = gCollisionEvents.copyContacts(pairs[i], nbContacts);
 
-			// 3. check if entity1 has a BehaviourScript (will be assigned as a childScript)
-			std::shared_ptr<Component> entity1Comp = entity1->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (entity1Comp != nullptr) {
-				std::shared_ptr<BehaviourScript> entity1Script = std::static_pointer_cast<BehaviourScript>(entity1Comp);
-				// 4. if so call onCollisionEnter(PxShape* localShape = shape1, PxShape* otherShape = shape0, collision stuff to figure out)
-				//entity1Script->onCollisionEnter(shape1, shape0, entity0, contacts, nbContacts);
-				ContactCollision collision(ContactCollision::ContactCollisionTypes::ENTER, entity1Script, shape1, shape0, entity0, contacts, nbContacts);
-				gContactCollisions.push_back(collision);
-			}
+		// 1. if entity0 has a BehaviourScript, it gets onCollisionEnter/Exit(localShape = shape0, otherShape = shape1, ...)
+		if (entity0Script != nullptr) {
+			gCollisionEvents.addContactCollision(collisionType, entity0Script, shape0, shape1, entity1, firstContact, nbContacts);
 		}
-		else if (pairs[i].flags & PxContactPairFlag::eACTOR_PAIR_LOST_TOUCH) {
-			// 1. check if entity0 has a BehaviourScript (will be assigned as a childScript)
-			std::shared_ptr<Component> entity0Comp = entity0->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (entity0Comp != nullptr) {
-				std::shared_ptr<BehaviourScript> entity0Script = std::static_pointer_cast<BehaviourScript>(entity0Comp);
-				// 2. if so call onCollisionExit(PxShape* localShape = shape0, PxShape* otherShape = shape1, collision stuff to figure out)
-				//entity0Script->onCollisionExit(shape0, shape1, entity1, contacts, nbContacts);
-				ContactCollision collision(ContactCollision::ContactCollisionTypes::EXIT, entity0Script, shape0, shape1, entity1, contacts, nbContacts);
-				gContactCollisions.push_back(collision);
-			}
 
-			// 3. check if entity1 has a BehaviourScript (will be assigned as a childScript)
-			std::shared_ptr<Component> entity1Comp = entity1->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (entity1Comp != nullptr) {
-				std::shared_ptr<BehaviourScript> entity1Script = std::static_pointer_cast<BehaviourScript>(entity1Comp);
-				// 4. if so call onCollisionExit(PxShape* localShape = shape1, PxShape* otherShape = shape0, collision stuff to figure out)
-				//entity1Script->onCollisionExit(shape1, shape0, entity0, contacts, nbContacts);
-				ContactCollision collision(ContactCollision::ContactCollisionTypes::EXIT, entity1Script, shape1, shape0, entity0, contacts, nbContacts);
-				gContactCollisions.push_back(collision);
-			}
+		// 2. if entity1 has a BehaviourScript, it gets onCollisionEnter/Exit(localShape = shape1, otherShape = shape0, ...)
+		if (entity1Script != nullptr) {
+			gCollisionEvents.addContactCollision(collisionType, entity1Script, shape1, shape0, entity0, firstContact, nbContacts);
 		}
 	}
 }
@@ -248,8 +346,6 @@ void CustomSimulationEventCallback::onContact(const PxContactPairHeader &pairHea
 
 
 
-
-
 // I think this gets called ONCE for all pairs that a collision was reported for during this frame...
 //https://docs.nvidia.com/gameworks/content/gameworkslibrary/physx/guide/Manual/RigidBodyCollision.html
 //The code above iterates through all pairs of overlapping shapes that involve a trigger shape.If it is found that the treasure has been touched by the submarine then the flag gTreasureFound is set true.
@@ -279,34 +375,24 @@ void CustomSimulationEventCallback::onTrigger(PxTriggerPair *pairs, PxU32 count)
 		// 2. if either/both entities have been flagged to be destroyed...
 		if (triggerEntity->getDestroyFlag() || otherEntity->getDestroyFlag()) continue;
 
-		// NOW CALLBACK PROPER BEHAVIOURSCRIPT METHOD FOR THE TRIGGER ENTITY...
-
+		// NOW RECORD THE PROPER BEHAVIOURSCRIPT METHOD FOR THE TRIGGER ENTITY (dispatched in endStep())...
+		TriggerCollision::TriggerCollisionTypes collisionType;
 		if (pairs[i].status == PxPairFlag::eNOTIFY_TOUCH_FOUND) {
-			// 1. check if triggerEntity has a BehaviourScript (will be assigned as a childScript)
-			std::shared_ptr<Component> triggerComp = triggerEntity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (triggerComp != nullptr) {
-				std::shared_ptr<BehaviourScript> triggerScript = std::static_pointer_cast<BehaviourScript>(triggerComp);
-				// 2. if so call onTriggerEnter(PxShape* localShape = triggerShape, PxShape* otherShape, Entity *otherEntity)
-				//triggerScript->onTriggerEnter(pairs[i].triggerShape, pairs[i].otherShape, otherEntity);
-				TriggerCollision collision(TriggerCollision::TriggerCollisionTypes::ENTER, triggerScript, pairs[i].triggerShape, pairs[i].otherShape, otherEntity);
-				gTriggerCollisions.push_back(collision);
-			}
+			collisionType = TriggerCollision::TriggerCollisionTypes::ENTER;
 		}
 		else if (pairs[i].status == PxPairFlag::eNOTIFY_TOUCH_LOST) {
-			// 1. check if triggerEntity has a BehaviourScript (will be assigned as a childScript)
-			std::shared_ptr<Component> triggerComp = triggerEntity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (triggerComp != nullptr) {
-				std::shared_ptr<BehaviourScript> triggerScript = std::static_pointer_cast<BehaviourScript>(triggerComp);
-				// 2. if so call onTriggerExit(PxShape* localShape = triggerShape, PxShape* otherShape, Entity *otherEntity)
-				//triggerScript->onTriggerExit(pairs[i].triggerShape, pairs[i].otherShape, otherEntity);
-				TriggerCollision collision(TriggerCollision::TriggerCollisionTypes::EXIT, triggerScript, pairs[i].triggerShape, pairs[i].otherShape, otherEntity);
-				gTriggerCollisions.push_back(collision);
-			}	
+			collisionType = TriggerCollision::TriggerCollisionTypes::EXIT;
 		}
 		else {
 			std::cout << "ERROR: PhysicsManager.cpp | onTrigger() callback has invalid enum" << std::endl;
 			return;
 		}
+
+		// if triggerEntity has a BehaviourScript, it gets onTriggerEnter/Exit(localShape = triggerShape, otherShape, otherEntity)
+		BehaviourScript *triggerScript = triggerEntity->getBehaviourScript();
+		if (triggerScript != nullptr) {
+			gCollisionEvents.addTriggerCollision(collisionType, triggerScript, pairs[i].triggerShape, pairs[i].otherShape, otherEntity);
+		}
 	}
 }
 
@@ -334,10 +420,10 @@ void PhysicsManager::init() {
 		exit(EXIT_FAILURE);
 	}
 	
+	// PVD has to exist before PxPhysics, but it only connects to something if asked to (live client or file capture)...
+	_pvdCapture = new PvdCapture(*gFoundation, _pvdSettings);
 	#ifdef PVD_ENABLED
-	gPvd = PxCreatePvd(*gFoundation);
-	PxPvdTransport* transport = PxDefaultPvdSocketTransportCreate(PVD_HOST, 5425, 10);
-	gPvd->connect(*transport,PxPvdInstrumentationFlag::eALL);
+	gPvd = _pvdCapture->getPvd();
 	#endif // PVD_ENABLED
 
 	PxTolerancesScale simScale;
@@ -366,6 +452,10 @@ void PhysicsManager::init() {
 		exit(EXIT_FAILURE);
 	}
 
+	// static map collision meshes get loaded from their cooked blobs when the first scene is built...
+	_cookedMeshCache = new CookedMeshCache(gPhysics, gCooking, _broker->getLoadingManager());
+	_prefabTable = new PrefabTable(gPhysics, _cookedMeshCache);
+
 	// SETUP VEHICLE SDK
 	PxInitVehicleSDK(*gPhysics);
 	PxVehicleSetBasisVectors(PxVec3(0.0f, 1.0f, 0.0f), PxVec3(0.0f, 0.0f, 1.0f)); // up = y, forward = z
@@ -380,14 +470,29 @@ void PhysicsManager::loadScene1(int numPlayers) {
 	PxSceneDesc sceneDesc(gPhysics->getTolerancesScale());
 	sceneDesc.gravity = PxVec3(0.0f, -98.1f, 0.0f);
 
-	PxU32 numWorkers = 1; // 1 thread off the main thread (~~~~~~~~MAYBE CHANGE TO 0, to run on main thread?)
-	gDispatcher = PxDefaultCpuDispatcherCreate(numWorkers);
+	gDispatcher = new JobSystemCpuDispatcher(_broker->getJobSystem());
 	sceneDesc.cpuDispatcher = gDispatcher;
-	sceneDesc.filterShader = CustomFilterShader; // TODO: change this later to use a finished CustomFilterShader
+	initContactReportPolicy(gContactReportPolicy);
+	sceneDesc.filterShader = CustomFilterShader;
+	sceneDesc.filterShaderData = &gContactReportPolicy;
+	sceneDesc.filterShaderDataSize = sizeof(ContactReportPolicy);
 	sceneDesc.simulationEventCallback = &gSimEventCallback;
+	sceneDesc.broadPhaseType = PxBroadPhaseType::eMBP; // only MBP has regions + out of bounds notifications
+	sceneDesc.broadPhaseCallback = &gBroadPhaseCallback;
+	sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS; // endStep() only refreshes the pose buffers of actors that moved
 
 	PxScene *physxScene = gPhysics->createScene(sceneDesc);
 
+	// BROADPHASE REGIONS (have to be there before the first simulate())...
+	PxBounds3 regions[BROADPHASE_REGION_SUBDIVISIONS * BROADPHASE_REGION_SUBDIVISIONS];
+	PxU32 nbRegions = PxBroadPhaseExt::createRegionsFromWorldBounds(regions, WORLD_BOUNDS, BROADPHASE_REGION_SUBDIVISIONS);
+	for (PxU32 i = 0; i < nbRegions; i++) {
+		PxBroadPhaseRegion region;
+		region.bounds = regions[i];
+		region.userData = nullptr;
+		physxScene->addBroadPhaseRegion(region);
+	}
+
 	#ifdef PVD_ENABLED
 	PxPvdSceneClient *pvdClient = physxScene->getScenePvdClient();
 	if (pvdClient)
@@ -398,20 +503,36 @@ void PhysicsManager::loadScene1(int numPlayers) {
 	}
 	#endif // PVD_ENABLED
 
-	//Create the batched scene queries for the suspension raycasts.
-	PxU32 maxNumVehicles = 6; // 6 players
+	const int nbVehicles = std::max(std::min(_nbVehicles, (int)MAX_NB_VEHICLES), numPlayers); // every human needs a cart
+
+	//Create the batched scene queries for the suspension raycasts (1 per batch of carts).
+	PxU32 nbBatches = (nbVehicles + VEHICLES_PER_BATCH - 1) / VEHICLES_PER_BATCH;
 	PxU32 maxNumWheelsPerVehicle = 4;
-	gVehicleSceneQueryData = VehicleSceneQueryData::allocate(maxNumVehicles, maxNumWheelsPerVehicle, 1, maxNumVehicles, WheelSceneQueryPreFilterBlocking, NULL, gAllocator); // setup for 1 batch (batch ID=0 ???)
-	gBatchQuery = VehicleSceneQueryData::setUpBatchedSceneQuery(0, *gVehicleSceneQueryData, physxScene);
+	gVehicleSceneQueryData = VehicleSceneQueryData::allocate(nbBatches * VEHICLES_PER_BATCH, maxNumWheelsPerVehicle, 1, VEHICLES_PER_BATCH, WheelSceneQueryPreFilterBlocking, NULL, gAllocator); // last batch may not be full, but its buffer slice still has to exist
+	for (PxU32 i = 0; i < nbBatches; i++) {
+		gBatchQueries.push_back(VehicleSceneQueryData::setUpBatchedSceneQuery(i, *gVehicleSceneQueryData, physxScene));
+	}
 
 	//Create the friction table for each combination of tire and surface type.
 	initFrictionPairs();
 
+	//Create the batch for the AI navigation rays (every cart could end up AI controlled with the autopilot).
+	_aiRays = new RaycastBatch(physxScene, nbVehicles * PlayerScript::MAX_NAVIGATION_RAYS);
+
 
 	// ENTITY INIT...
 
 	_activeScene = std::make_shared<GameScene>(physxScene);
 
+	// pickups get recycled instead of released (see physics/pickuppool.h)...
+	_pickupPool = new PickupActorPool(gPhysics, physxScene, _prefabTable);
+	_pickupPool->prewarm();
+	_activeScene->_pickupPool = _pickupPool;
+
+	// resting pickups get found by position instead of through trigger pairs (see physics/pickupgrid.h)...
+	_pickupGrid = new PickupGrid(WORLD_BOUNDS, PICKUP_GRID_CELL_SIZE);
+	_activeScene->_pickupGrid = _pickupGrid;
+
 
 	// GROUND:
 	std::shared_ptr<Ground> ground = std::dynamic_pointer_cast<Ground>(instantiateEntity(EntityTypes::GROUND, PxTransform(0.0f, 0.0f, 0.0f, PxQuat(PxIdentity)), "ground"));
@@ -442,721 +563,713 @@ void PhysicsManager::loadScene1(int numPlayers) {
 	std::shared_ptr<Obstacle7> redWallTop = std::dynamic_pointer_cast<Obstacle7>(instantiateEntity(EntityTypes::OBSTACLE7, PxTransform(160.0f, 0.0f, -72.0f, PxQuat(PxIdentity)), "redWallTop"));
 
 
-	// only cases:
-	// numPlayers = 1 -> 1,-1,-2,-3,-4,-5
-	// numPlayers = 2 -> 1, 2, -1, -2, -3, -4
-	// numPlayers = 3 -> 1, 2, 3, -1, -2, -3
-	// numPlayers = 4 -> 1, 2, 3, 4, -1, -2
+	// VEHICLES...
+	static std::vector<std::string> vehicleNames; // NOTE: PhysX only stores the name pointer, so these live for the whole program
+	if (vehicleNames.empty()) {
+		for (int i = 0; i < MAX_NB_VEHICLES; i++) vehicleNames.push_back("vehicle" + std::to_string(i));
+	}
+	_nbVehicles = nbVehicles;
+	std::vector<PxTransform> vehicleSpawnTransforms = getShuffledVehicleSpawnTransforms();
+	for (int i = 0; i < nbVehicles; i++) {
+		std::shared_ptr<ShoppingCartPlayer> vehicle = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(i), vehicleNames.at(i).c_str()));
+		PlayerScript *vehicleScript = static_cast<PlayerScript*>(vehicle->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		assignPlayer(vehicleScript, i, numPlayers);
+	}
+}
 
-	// NOTE: I'm specifying starting angle in range [-pi, pi]
-	std::vector<PxTransform> vehicleSpawnTransforms;
-	vehicleSpawnTransforms.push_back(PxTransform(-237.0f, 5.0f, -20.0f, PxQuat(1.5708f, PxVec3(0.0f, 1.0f, 0.0f))));
-	vehicleSpawnTransforms.push_back(PxTransform(-237.0f, 5.0f, 20.0f, PxQuat(1.5708f, PxVec3(0.0f, 1.0f, 0.0f))));
-	vehicleSpawnTransforms.push_back(PxTransform(101.18f, 5.0f, 215.25f, PxQuat(-2.6180f, PxVec3(0.0f, 1.0f, 0.0f))));
-	vehicleSpawnTransforms.push_back(PxTransform(135.82f, 5.0f, 195.25f, PxQuat(-2.6180f, PxVec3(0.0f, 1.0f, 0.0f))));
-	vehicleSpawnTransforms.push_back(PxTransform(135.82f, 5.0f, -195.25f, PxQuat(-0.5236f, PxVec3(0.0f, 1.0f, 0.0f))));
-	vehicleSpawnTransforms.push_back(PxTransform(101.18f, 5.0f, -215.25f, PxQuat(-0.5236f, PxVec3(0.0f, 1.0f, 0.0f))));
 
-	std::random_shuffle(vehicleSpawnTransforms.begin(), vehicleSpawnTransforms.end());
-
-
-	// VEHICLE 0:
-	std::shared_ptr<ShoppingCartPlayer> vehicle0 = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(0), "vehicle0"));
-	std::shared_ptr<PlayerScript> vehicle0Script = std::static_pointer_cast<PlayerScript>(vehicle0->getComponent(ComponentTypes::PLAYER_SCRIPT));
-	vehicle0Script->_playerType = PlayerScript::PlayerTypes::HUMAN;
-	vehicle0Script->_inputID = 1;
-
-	// VEHICLE 1:
-	std::shared_ptr<ShoppingCartPlayer> vehicle1 = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(1), "vehicle1"));
-	std::shared_ptr<PlayerScript> vehicle1Script = std::static_pointer_cast<PlayerScript>(vehicle1->getComponent(ComponentTypes::PLAYER_SCRIPT));
-	vehicle1Script->_playerType = numPlayers > 1 ? PlayerScript::PlayerTypes::HUMAN : PlayerScript::PlayerTypes::BOT;
-	vehicle1Script->_inputID = numPlayers > 1 ? 2 : -1;
-
-	// VEHICLE 2:
-	std::shared_ptr<ShoppingCartPlayer> vehicle2 = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(2), "vehicle2"));
-	std::shared_ptr<PlayerScript> vehicle2Script = std::static_pointer_cast<PlayerScript>(vehicle2->getComponent(ComponentTypes::PLAYER_SCRIPT));
-	vehicle2Script->_playerType = numPlayers > 2 ? PlayerScript::PlayerTypes::HUMAN : PlayerScript::PlayerTypes::BOT;
-	vehicle2Script->_inputID = numPlayers > 2 ? 3 : (numPlayers - 3);
-
-	// VEHICLE 3:
-	std::shared_ptr<ShoppingCartPlayer> vehicle3 = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(3), "vehicle3"));
-	std::shared_ptr<PlayerScript> vehicle3Script = std::static_pointer_cast<PlayerScript>(vehicle3->getComponent(ComponentTypes::PLAYER_SCRIPT));
-	vehicle3Script->_playerType = numPlayers > 3 ? PlayerScript::PlayerTypes::HUMAN : PlayerScript::PlayerTypes::BOT;
-	vehicle3Script->_inputID = numPlayers > 3 ? 4 : (numPlayers - 4);
-
-	// VEHICLE 4:
-	std::shared_ptr<ShoppingCartPlayer> vehicle4 = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(4), "vehicle4"));
-	std::shared_ptr<PlayerScript> vehicle4Script = std::static_pointer_cast<PlayerScript>(vehicle4->getComponent(ComponentTypes::PLAYER_SCRIPT));
-	vehicle4Script->_playerType = PlayerScript::PlayerTypes::BOT;
-	vehicle4Script->_inputID = numPlayers - 5;
-	
-	// VEHICLE 5:
-	std::shared_ptr<ShoppingCartPlayer> vehicle5 = std::dynamic_pointer_cast<ShoppingCartPlayer>(instantiateEntity(EntityTypes::SHOPPING_CART_PLAYER, vehicleSpawnTransforms.at(5), "vehicle5"));
-	std::shared_ptr<PlayerScript> vehicle5Script = std::static_pointer_cast<PlayerScript>(vehicle5->getComponent(ComponentTypes::PLAYER_SCRIPT));
-	vehicle5Script->_playerType = PlayerScript::PlayerTypes::BOT;
-	vehicle5Script->_inputID = numPlayers - 6;
-}
+// WARM RESTART...
+// keeps the PxScene, dispatcher, batch query, friction pairs, static actors (cooked triangle meshes) and the carts' cooked convex meshes alive,
+// and only throws away the pickups + puts the carts back at (reshuffled) spawn points with fresh gameplay state
+// NOTE: only valid after loadScene1() and before cleanupScene1()
+void PhysicsManager::restartScene1(int numPlayers) {
+	PROFILE_SCOPE("PhysicsManager::restartScene1");
 
+	// can't touch actors while the workers are still simulating...
+	discardStepInFlight();
 
-void PhysicsManager::cleanupScene1() {
+	_pickupPool->printStats(); // last match
+	_pickupPool->resetStats();
 
+	// REMOVE EVERY DYNAMIC ENTITY EXCEPT THE CARTS (pickups, spare change, etc.) (NOTE: they go back into the pickup pool)...
 	std::vector<std::shared_ptr<Entity>> entitiesCopy = _activeScene->_entities;
 	for (std::shared_ptr<Entity> &entity : entitiesCopy) {
+		if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) continue;
+		if (entity->_actor->is<PxRigidDynamic>() == nullptr) continue; // static geometry stays
 		_activeScene->removeEntity(entity);
 	}
 
-	//std::cout << _activeScene->_entities.size() << std::endl;
-
-	gBatchQuery->release();
-	gBatchQuery = NULL;
-	gVehicleSceneQueryData->free(gAllocator);
-	gVehicleSceneQueryData = NULL;
-	gFrictionPairs->release();
-	gFrictionPairs = NULL;
-
-	_activeScene->_physxScene->release();
-	_activeScene->_physxScene = nullptr;
-	_activeScene = nullptr;
-
-	gDispatcher->release();
-	gDispatcher = NULL;
+	// RESET THE CARTS...
+	std::vector<PxTransform> vehicleSpawnTransforms = getShuffledVehicleSpawnTransforms();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &shoppingCartPlayers = _activeScene->getAllShoppingCartPlayers();
+	for (size_t i = 0; i < shoppingCartPlayers.size(); i++) {
+		const std::shared_ptr<ShoppingCartPlayer> &cart = shoppingCartPlayers.at(i);
+		cart->_shoppingCartBase->resetState(vehicleSpawnTransforms.at(i));
+		cart->resetPoseHistory();
+
+		PlayerScript *cartScript = static_cast<PlayerScript*>(cart->getComponent(ComponentTypes::PLAYER_SCRIPT));
+		assignPlayer(cartScript, (int)i, numPlayers);
+		cartScript->resetState();
+	}
 }
 
 
+// SNAPSHOTS...
+// per dynamic entity: handle, type, rigid body state, render pose history, then the type specific state (carts: vehicle + player script, pickups: pooled points)
+// static geometry never changes during a match so it isn't saved
+void PhysicsManager::writeSnapshot(SnapshotWriter &writer) {
+	PROFILE_SCOPE("PhysicsManager::writeSnapshot");
 
-void PhysicsManager::updateSeconds(double fixedDeltaTime) {
-	// call FIXEDUPDATE() for all behaviour scripts...
-	std::vector<std::shared_ptr<Entity>> entitiesCopy = _activeScene->_entities;
-	for (std::shared_ptr<Entity> &entity : entitiesCopy) {
-		std::shared_ptr<Component> comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-		if (comp != nullptr) {
-			std::shared_ptr<BehaviourScript> script = std::static_pointer_cast<BehaviourScript>(comp);
-			script->fixedUpdate(fixedDeltaTime);
+	endStep(); // NOTE: Broker::captureSnapshot() already did this before cleaning up destroyed entities, so normally there's nothing in flight here
+
+	uint32_t nbDynamicEntities = 0;
+	for (std::shared_ptr<Entity> &entity : _activeScene->_entities) {
+		if (entity->_actor->is<PxRigidDynamic>()) nbDynamicEntities++;
+	}
+	writer.write(nbDynamicEntities);
+
+	ComponentPools *pools = _activeScene->_componentPools;
+	for (std::shared_ptr<Entity> &entity : _activeScene->_entities) {
+		PxRigidDynamic *actor = entity->_actor->is<PxRigidDynamic>();
+		if (actor == nullptr) continue;
+
+		writer.write(entity->_handle);
+		writer.write(entity->getTag());
+		writer.write(actor->getGlobalPose());
+		writer.write(actor->getLinearVelocity());
+		writer.write(actor->getAngularVelocity());
+		writer.write(actor->isSleeping());
+		writer.write(entity->_prevPose);
+		writer.write(entity->_currPose);
+
+		if (entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) {
+			static_cast<ShoppingCartPlayer*>(entity.get())->_shoppingCartBase->writeSnapshot(writer);
+			static_cast<PlayerScript*>(entity->getComponent(ComponentTypes::PLAYER_SCRIPT))->writeSnapshot(writer);
+		}
+		else {
+			uint32_t pickupIndex = pools->getPickupIndex(entity->_handle);
+			writer.write(pickupIndex != INVALID_POOL_INDEX ? pools->_pickups._points[pickupIndex] : 0);
+			writer.write(pickupIndex != INVALID_POOL_INDEX ? pools->_pickups._isSolid[pickupIndex] : (uint8_t)0);
 		}
 	}
+}
 
-	// FURTHER VEHICLE UPDATES...
-
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> shoppingCartPlayers = _activeScene->getAllShoppingCartPlayers();
 
-	//Raycasts...
-	std::vector<PxVehicleWheels*> vehiclesVector;
-	for (std::shared_ptr<ShoppingCartPlayer> &shoppingCartPlayer : shoppingCartPlayers) {
-		vehiclesVector.push_back(shoppingCartPlayer->_shoppingCartBase->_vehicle4W);
-	}
+// NOTE: entities that are still alive get overwritten in place (no actor/shape creation), only ones that were destroyed since the capture get re-instantiated
+bool PhysicsManager::readSnapshot(SnapshotReader &reader) {
+	PROFILE_SCOPE("PhysicsManager::readSnapshot");
+
+	endStep(); // NOTE: same as writeSnapshot(), Broker::restoreSnapshot() already did this
+	gCollisionEvents.reset();
+	_snapshotRemap.clear();
+
+	uint32_t nbDynamicEntities = 0;
+	if (!reader.read(nbDynamicEntities)) return false;
+
+	std::vector<EntityHandle> restoredHandles;
+	restoredHandles.reserve(nbDynamicEntities);
+
+	ComponentPools *pools = _activeScene->_componentPools;
+	for (uint32_t i = 0; i < nbDynamicEntities; i++) {
+		EntityHandle handle;
+		EntityTypes tag = EntityTypes::NONE;
+		PxTransform pose, prevPose, currPose;
+		PxVec3 linearVelocity, angularVelocity;
+		bool isSleeping = false;
+		reader.read(handle);
+		reader.read(tag);
+		reader.read(pose);
+		reader.read(linearVelocity);
+		reader.read(angularVelocity);
+		reader.read(isSleeping);
+		reader.read(prevPose);
+		reader.read(currPose);
+		if (reader.hasFailed()) return false;
+
+		std::shared_ptr<Entity> entity = _activeScene->getEntity(handle);
+		if (entity == nullptr || entity->getTag() != tag) {
+			if (tag == EntityTypes::SHOPPING_CART_PLAYER) {
+				std::cout << "ERROR: snapshot refers to a cart that isn't in the scene anymore" << std::endl;
+				return false;
+			}
+			entity = instantiateEntity(tag, pose, "SnapshotItem");
+			_snapshotRemap.push_back(std::make_pair(handle, entity));
+		}
+		restoredHandles.push_back(entity->_handle);
 
-	PxRaycastQueryResult *raycastResults = gVehicleSceneQueryData->getRaycastQueryResultBuffer(0); // ONLY 1 buffer set up ID = 0
-	const PxU32 raycastResultsSize = gVehicleSceneQueryData->getQueryResultBufferSize();
-	PxVehicleSuspensionRaycasts(gBatchQuery, vehiclesVector.size(), vehiclesVector.data(), raycastResultsSize, raycastResults);
+		PxRigidDynamic *actor = entity->_actor->is<PxRigidDynamic>();
+		actor->setGlobalPose(pose);
+		entity->_prevPose = prevPose;
+		entity->_currPose = currPose;
 
-	//Vehicle update...
-	const PxVec3 grav = _activeScene->_physxScene->getGravity();
-	std::vector<PxWheelQueryResult> wheelQueryResults;
-	wheelQueryResults.resize(vehiclesVector.size()*PX_MAX_NB_WHEELS); // have a slot for every possible wheel of each vehicle in order
+		if (tag == EntityTypes::SHOPPING_CART_PLAYER) {
+			if (!static_cast<ShoppingCartPlayer*>(entity.get())->_shoppingCartBase->readSnapshot(reader)) return false;
+			if (!static_cast<PlayerScript*>(entity->getComponent(ComponentTypes::PLAYER_SCRIPT))->readSnapshot(reader)) return false;
+		}
+		else {
+			int points = 0;
+			uint8_t isSolid = 0;
+			reader.read(points);
+			reader.read(isSolid);
+			uint32_t pickupIndex = pools->getPickupIndex(entity->_handle);
+			if (pickupIndex != INVALID_POOL_INDEX) pools->_pickups._points[pickupIndex] = points;
+
+			// trigger <-> solid decides whether it's kinematic, so it has to be restored before the velocities...
+			if (!isSolid && !(actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC)) {
+				actor->setLinearVelocity(PxVec3(0.0f));
+				actor->setAngularVelocity(PxVec3(0.0f));
+			}
+			setPickupSolid(entity.get(), isSolid != 0);
+			actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, isSolid == 0);
+		}
 
-	std::vector<PxVehicleWheelQueryResult> vehicleQueryResults;
-	for (int i = 0; i < vehiclesVector.size(); i++) {
-		vehicleQueryResults.push_back({ &wheelQueryResults[i*PX_MAX_NB_WHEELS], vehiclesVector[i]->mWheelsSimData.getNbWheels() });
+		if (!(actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC)) {
+			actor->setLinearVelocity(linearVelocity);
+			actor->setAngularVelocity(angularVelocity);
+			if (isSleeping) actor->putToSleep();
+		}
 	}
 
-	PxVehicleUpdates(fixedDeltaTime, grav, *gFrictionPairs, vehiclesVector.size(), vehiclesVector.data(), vehicleQueryResults.data());
-
-	for (int i = 0; i < vehiclesVector.size(); i++) {
-		shoppingCartPlayers.at(i)->_shoppingCartBase->setIsAirborne(vehiclesVector.at(i)->getRigidDynamicActor()->isSleeping() ? false : PxVehicleIsInAir(vehicleQueryResults.at(i)));
+	// REMOVE DYNAMIC ENTITIES THAT DIDN'T EXIST YET WHEN THE SNAPSHOT WAS TAKEN...
+	auto handleLess = [](const EntityHandle &a, const EntityHandle &b) { return a._slot != b._slot ? a._slot < b._slot : a._generation < b._generation; };
+	std::sort(restoredHandles.begin(), restoredHandles.end(), handleLess);
+	std::vector<std::shared_ptr<Entity>> entitiesToRemove;
+	for (std::shared_ptr<Entity> &entity : _activeScene->_entities) {
+		if (entity->_actor->is<PxRigidDynamic>() == nullptr) continue;
+		if (!std::binary_search(restoredHandles.begin(), restoredHandles.end(), entity->_handle, handleLess)) entitiesToRemove.push_back(entity);
+	}
+	for (std::shared_ptr<Entity> &entity : entitiesToRemove) {
+		_activeScene->removeEntity(entity);
 	}
 
+	return !reader.hasFailed();
+}
 
 
-	// clear collision vectors...
-	gContactCollisions.clear();
-	gTriggerCollisions.clear();
+std::shared_ptr<Entity> PhysicsManager::resolveSnapshotHandle(EntityHandle handle) {
+	for (std::pair<EntityHandle, std::shared_ptr<Entity>> &remap : _snapshotRemap) {
+		if (remap.first == handle) return remap.second;
+	}
+	return _activeScene->getEntity(handle);
+}
 
-	// Scene update...
-	_activeScene->_physxScene->simulate(fixedDeltaTime);
-	_activeScene->_physxScene->fetchResults(true); // wait for results to come in before moving on to next system
 
-	// RESET HIT FLAG...
-	for (std::shared_ptr<ShoppingCartPlayer> &shoppingCartPlayer : shoppingCartPlayers) {
-		shoppingCartPlayer->_shoppingCartBase->_wasHitFrameTimer--;
-		if (shoppingCartPlayer->_shoppingCartBase->_wasHitFrameTimer < 0) shoppingCartPlayer->_shoppingCartBase->_wasHitFrameTimer = 0;
-	}
+std::vector<PxTransform> PhysicsManager::getShuffledVehicleSpawnTransforms() {
+	// NOTE: std::shuffle instead of std::random_shuffle (gone in C++17), the engine is seeded from rand() so replays/benchmarks (which reseed rand()) still get the same spawns
+	std::mt19937 shuffleEngine((unsigned int)rand());
 
-	// now that fetchResults() has cached all collision events in the 2 vectors, call the proper events
-	for (ContactCollision &collision : gContactCollisions) {
-		if (collision._collisionType == ContactCollision::ContactCollisionTypes::ENTER) {
-			collision._caller->onCollisionEnter(collision._localShape, collision._otherShape, collision._otherEntity, collision._contacts, collision._nbContacts);
-		}
-		else {
-			collision._caller->onCollisionExit(collision._localShape, collision._otherShape, collision._otherEntity, collision._contacts, collision._nbContacts);
+	// NOTE: I'm specifying starting angle in range [-pi, pi]
+	std::vector<PxTransform> vehicleSpawnTransforms;
+	if (_nbVehicles > DEFAULT_NB_VEHICLES) {
+		// SPAWN RINGS...
+		// the hand placed spots all sit on the outer aisle (~238 from the middle), so candidates go on that ring and rings further in,
+		// spread evenly along each ring and facing the middle of the store like the hand placed ones.
+		// every candidate has to be inside WORLD_BOUNDS and clear of the static geometry (cart sized box overlap, the ground's floor is below it),
+		// then the carts get a random pick of the clear ones, so they end up spread over all the rings instead of packed onto the outer one
+		const float OUTER_RING_RADIUS = 237.8f;
+		const float RING_GAP = 30.0f;
+		const float MIN_CART_SPACING = 20.0f; // along the ring
+		const float SPAWN_HEIGHT = 5.0f;
+		const PxBoxGeometry SPAWN_CLEARANCE_BOX(PxVec3(3.5f, 1.5f, 4.0f)); // chassis (3.5 x 3 x 5) half extents + some room to turn
+		const PxReal SPAWN_BOUNDS_MARGIN = 10.0f; // no spawning right against the edge of the broadphase
+
+		std::vector<PxTransform> blockedSpawnTransforms;
+		for (float radius = OUTER_RING_RADIUS; radius > MIN_CART_SPACING; radius -= RING_GAP) {
+			int nbOnRing = (int)(2.0f * PxPi * radius / MIN_CART_SPACING);
+			for (int i = 0; i < nbOnRing; i++) {
+				float ringAngle = 2.0f * PxPi * i / nbOnRing;
+				PxVec3 pos(radius * PxCos(ringAngle), SPAWN_HEIGHT, radius * PxSin(ringAngle));
+				float startingAngle = PxAtan2(-pos.x, -pos.z); // forward is +z at angle 0
+				PxTransform transform(pos, PxQuat(startingAngle, PxVec3(0.0f, 1.0f, 0.0f)));
+
+				if (!isSpawnClear(transform, SPAWN_CLEARANCE_BOX, SPAWN_BOUNDS_MARGIN)) blockedSpawnTransforms.push_back(transform);
+				else vehicleSpawnTransforms.push_back(transform);
+			}
 		}
-	}
 
-	for (TriggerCollision &collision : gTriggerCollisions) {
-		if (collision._collisionType == TriggerCollision::TriggerCollisionTypes::ENTER) {
-			collision._caller->onTriggerEnter(collision._localShape, collision._otherShape, collision._otherEntity);
-		}
-		else {
-			collision._caller->onTriggerExit(collision._localShape, collision._otherShape, collision._otherEntity);
+		std::shuffle(vehicleSpawnTransforms.begin(), vehicleSpawnTransforms.end(), shuffleEngine);
+		if ((int)vehicleSpawnTransforms.size() < _nbVehicles) {
+			std::cout << "WARNING: only " << vehicleSpawnTransforms.size() << " clear spawn points for " << _nbVehicles << " carts, the rest spawn on blocked ones" << std::endl;
+			vehicleSpawnTransforms.insert(vehicleSpawnTransforms.end(), blockedSpawnTransforms.begin(), blockedSpawnTransforms.end());
 		}
+		vehicleSpawnTransforms.resize(_nbVehicles);
+		return vehicleSpawnTransforms;
 	}
 
-	// ANTI-FLIP OVER...
-	// ~~~~~~NOTE: should this be moved to before simulate() ???????
-	for (std::shared_ptr<ShoppingCartPlayer> &cart : shoppingCartPlayers) {
-		PxVec3 cartPos = cart->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
-		PxQuat cartRot = cart->_actor->is<PxRigidDynamic>()->getGlobalPose().q;
+	vehicleSpawnTransforms.push_back(PxTransform(-237.0f, 5.0f, -20.0f, PxQuat(1.5708f, PxVec3(0.0f, 1.0f, 0.0f))));
+	vehicleSpawnTransforms.push_back(PxTransform(-237.0f, 5.0f, 20.0f, PxQuat(1.5708f, PxVec3(0.0f, 1.0f, 0.0f))));
+	vehicleSpawnTransforms.push_back(PxTransform(101.18f, 5.0f, 215.25f, PxQuat(-2.6180f, PxVec3(0.0f, 1.0f, 0.0f))));
+	vehicleSpawnTransforms.push_back(PxTransform(135.82f, 5.0f, 195.25f, PxQuat(-2.6180f, PxVec3(0.0f, 1.0f, 0.0f))));
+	vehicleSpawnTransforms.push_back(PxTransform(135.82f, 5.0f, -195.25f, PxQuat(-0.5236f, PxVec3(0.0f, 1.0f, 0.0f))));
+	vehicleSpawnTransforms.push_back(PxTransform(101.18f, 5.0f, -215.25f, PxQuat(-0.5236f, PxVec3(0.0f, 1.0f, 0.0f))));
 
-		PxQuat clampedRot(glm::clamp(cartRot.x, -0.3f, 0.3f), cartRot.y, glm::clamp(cartRot.z, -0.3f, 0.3f), cartRot.w);
-		clampedRot = clampedRot.getNormalized();
+	std::shuffle(vehicleSpawnTransforms.begin(), vehicleSpawnTransforms.end(), shuffleEngine);
+	return vehicleSpawnTransforms;
+}
 
-		cart->_actor->is<PxRigidDynamic>()->setGlobalPose(PxTransform(cartPos, clampedRot));
-	}
+
+bool PhysicsManager::isSpawnClear(const PxTransform &transform, const PxBoxGeometry &box, PxReal boundsMargin) {
+	// INSIDE THE PLAYABLE SPACE...
+	PxBounds3 spawnBounds = PxBounds3::transformFast(transform, PxBounds3::centerExtents(PxVec3(0.0f), box.halfExtents));
+	if (spawnBounds.minimum.x < WORLD_BOUNDS.minimum.x + boundsMargin || spawnBounds.maximum.x > WORLD_BOUNDS.maximum.x - boundsMargin) return false;
+	if (spawnBounds.minimum.z < WORLD_BOUNDS.minimum.z + boundsMargin || spawnBounds.maximum.z > WORLD_BOUNDS.maximum.z - boundsMargin) return false;
+
+	// NOT INSIDE A SHELF / WALL (static actors only, the carts already in the scene on a warm restart are dynamic)...
+	PxOverlapBuffer hit;
+	PxQueryFilterData filterData(PxQueryFlag::eSTATIC | PxQueryFlag::eANY_HIT);
+	return !_activeScene->_physxScene->overlap(box, transform, hit, filterData);
 }
 
 
+// only cases:
+// numPlayers = 1 -> 1,-1,-2,-3,-4,-5
+// numPlayers = 2 -> 1, 2, -1, -2, -3, -4
+// numPlayers = 3 -> 1, 2, 3, -1, -2, -3
+// numPlayers = 4 -> 1, 2, 3, 4, -1, -2
+void PhysicsManager::assignPlayer(PlayerScript *script, int vehicleIndex, int numPlayers) {
+	if (vehicleIndex < numPlayers) {
+		script->_playerType = PlayerScript::PlayerTypes::HUMAN;
+		script->_inputID = vehicleIndex + 1;
+	}
+	else {
+		script->_playerType = PlayerScript::PlayerTypes::BOT;
+		script->_inputID = numPlayers - (vehicleIndex + 1);
+	}
+}
 
-void PhysicsManager::cleanup() {}
 
+void PhysicsManager::cleanupScene1() {
+	// can't release anything while the workers are still simulating...
+	discardStepInFlight();
 
+	// everything gets released for real, so unhook the pickup pool first...
+	_pickupPool->printStats();
+	_activeScene->_pickupPool = nullptr;
 
-std::shared_ptr<Entity> PhysicsManager::instantiateEntity(EntityTypes type, physx::PxTransform transform, const char *name) {
+	std::vector<std::shared_ptr<Entity>> entitiesCopy = _activeScene->_entities;
+	for (std::shared_ptr<Entity> &entity : entitiesCopy) {
+		_activeScene->removeEntity(entity);
+	}
 
-	std::shared_ptr<Entity> entity;
+	delete _pickupPool; // releases the parked actors
+	_pickupPool = nullptr;
 
-	switch (type) {
-	case EntityTypes::SHOPPING_CART_PLAYER:
-	{
-		// SHAPES / ACTOR...
-		VehicleShoppingCart *shoppingCartBase = new VehicleShoppingCart(gPhysics, gCooking);
-		shoppingCartBase->_vehicle4W->getRigidDynamicActor()->setGlobalPose(transform);
-		shoppingCartBase->_vehicle4W->getRigidDynamicActor()->setName(name);
+	_activeScene->_pickupGrid = nullptr;
+	delete _pickupGrid;
+	_pickupGrid = nullptr;
 
-		// DEFAULT: NON-KINEMATIC DYNAMIC (GRAVITY ENABLED)
+	//std::cout << _activeScene->_entities.size() << std::endl;
 
-		// ENTITY...
-		entity = std::make_shared<ShoppingCartPlayer>(shoppingCartBase);
-		break;
+	for (PxBatchQuery *batchQuery : gBatchQueries) {
+		batchQuery->release();
 	}
-	case EntityTypes::GROUND:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::GROUND_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::GROUND_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_GROUND, CollisionFlags::COLLISION_FLAG_GROUND_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
+	gBatchQueries.clear();
+	gWheelQueryResults.clear();
+	gVehicleQueryResults.clear();
+	gWheelConcurrentUpdates.clear();
+	gVehicleConcurrentUpdates.clear();
+	gVehicleSceneQueryData->free(gAllocator);
+	gVehicleSceneQueryData = NULL;
+	gFrictionPairs->release();
+	gFrictionPairs = NULL;
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
+	delete _aiRays; // releases its batch query
+	_aiRays = nullptr;
 
-		actor->attachShape(*shape);
+	_activeScene->_physxScene->release();
+	_activeScene->_physxScene = nullptr;
+	_activeScene = nullptr;
 
-		// ENTITY...
-		entity = std::make_shared<Ground>(actor);
-		break;
-	}
-	case EntityTypes::ROOF:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::ROOF_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::ROOF_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
+	delete gDispatcher;
+	gDispatcher = NULL;
+}
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
 
-		actor->attachShape(*shape);
 
-		// ENTITY...
-		entity = std::make_shared<Roof>(actor);
-		break;
+void PhysicsManager::discardStepInFlight() {
+	if (_isStepInFlight) {
+		_activeScene->_physxScene->fetchResults(true);
+		_isStepInFlight = false;
+		_pvdCapture->onStepEnd(); // still a step as far as a bounded capture is concerned
 	}
-	case EntityTypes::OBSTACLE1:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE1_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE1_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
+	// the callbacks only ever fill these during simulate()/fetchResults(), and endStep() won't run for this step,
+	// so whatever is in there points at entities/scripts that are about to be reset or released...
+	gCollisionEvents.reset();
+	gOutOfBoundsEntities.clear();
+}
 
-		actor->attachShape(*shape);
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle1>(actor);
-		break;
-	}
-	case EntityTypes::OBSTACLE2:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE2_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE2_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
+// runs 1 full blocking physics step...
+void PhysicsManager::updateSeconds(double fixedDeltaTime) {
+	PROFILE_SCOPE("PhysicsManager::updateSeconds");
 
-		actor->attachShape(*shape);
+	beginStep(fixedDeltaTime);
+	endStep();
+}
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle2>(actor);
-		break;
-	}
-	case EntityTypes::OBSTACLE3:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE3_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE3_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
 
-		actor->attachShape(*shape);
+// everything up to and including simulate(), the PhysX workers then run in the background until endStep() is called
+// (in pipelined mode the broker calls this right before rendering and endStep() at the start of the next frame)
+void PhysicsManager::beginStep(double fixedDeltaTime) {
+	PROFILE_SCOPE("Physics::beginStep");
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle3>(actor);
-		break;
+	InputReplay *inputReplay = _broker->getInputReplay();
+	inputReplay->beginPhysicsStep(_activeScene->_componentPools->_players._scripts.size()); // every cart feeds its input between here and endPhysicsStep()
+
+	// AI BOT RAYS...
+	// every bot's rays get queued into 1 batch (cheap, serial) and run at once, navigate() then reads its results from inside its own fixedUpdate()
+	const std::vector<PlayerScript*> &playerScripts = _activeScene->_componentPools->_players._scripts;
+	{
+		PROFILE_SCOPE("Physics::botRaycasts");
+		_aiRays->reset();
+		for (PlayerScript *playerScript : playerScripts) {
+			if (playerScript->isAIControlled()) playerScript->queueNavigationRays(*_aiRays);
+		}
+
+		BenchmarkTimer timer(_broker->_benchmarkResults != nullptr ? &_broker->_benchmarkResults->_aiRaycastBatchMillis : nullptr);
+		_aiRays->execute();
 	}
-	case EntityTypes::OBSTACLE4:
+	if (_broker->_benchmarkResults != nullptr) _broker->_benchmarkResults->_aiRaysPerStep.add(_aiRays->getNbRays());
+
+	// call FIXEDUPDATE() for the behaviour scripts that want it this step (resting pickups don't, see FixedUpdateModes)...
 	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE4_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE4_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
+		PROFILE_SCOPE("Physics::scriptFixedUpdate");
+		// NOTE: scripts can spawn entities in here (which appends to the set), so index up to the starting size instead of using iterators
+		std::vector<BehaviourScript*> &scripts = _activeScene->_componentPools->_fixedUpdates._scripts;
+		size_t nbScripts = scripts.size();
+		for (size_t i = 0; i < nbScripts; i++) {
+			scripts[i]->fixedUpdate(fixedDeltaTime);
+		}
+	}
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
+	inputReplay->endPhysicsStep();
 
-		actor->attachShape(*shape);
+	// FURTHER VEHICLE UPDATES...
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle4>(actor);
-		break;
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &shoppingCartPlayers = _activeScene->getAllShoppingCartPlayers();
+
+	// the player pool already keeps every vehicle handle packed in cart order (same order as shoppingCartPlayers)
+	std::vector<PxVehicleWheels*> &vehiclesVector = _activeScene->_componentPools->_players._vehicles;
+	const PxU32 nbVehicles = (PxU32)vehiclesVector.size();
+
+	// (re)point the per vehicle result buffers if the carts changed (only happens right after loading)...
+	if (gVehicleQueryResults.size() != nbVehicles) {
+		gWheelQueryResults.assign(nbVehicles * PX_MAX_NB_WHEELS, PxWheelQueryResult());
+		gWheelConcurrentUpdates.assign(nbVehicles * PX_MAX_NB_WHEELS, PxVehicleWheelConcurrentUpdateData());
+		gVehicleQueryResults.resize(nbVehicles);
+		gVehicleConcurrentUpdates.assign(nbVehicles, PxVehicleConcurrentUpdateData());
+		for (PxU32 i = 0; i < nbVehicles; i++) {
+			PxU32 nbWheels = vehiclesVector[i]->mWheelsSimData.getNbWheels();
+			gVehicleQueryResults[i] = { &gWheelQueryResults[i*PX_MAX_NB_WHEELS], nbWheels };
+			gVehicleConcurrentUpdates[i].concurrentWheelUpdates = &gWheelConcurrentUpdates[i*PX_MAX_NB_WHEELS];
+			gVehicleConcurrentUpdates[i].nbConcurrentWheelUpdates = nbWheels;
+		}
 	}
-	case EntityTypes::OBSTACLE5:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE5_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE5_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
+	// Raycasts + vehicle update, 1 job per batch...
+	// NOTE: with concurrent update data PxVehicleUpdates() doesn't write to the actors, so 1 batch's raycasts can't see another batch's half-updated carts
+	const PxVec3 grav = _activeScene->_physxScene->getGravity();
+	const PxU32 raycastResultsSize = gVehicleSceneQueryData->getQueryResultBufferSize();
+	const PxU32 nbBatches = (nbVehicles + VEHICLES_PER_BATCH - 1) / VEHICLES_PER_BATCH;
+	{
+		PROFILE_SCOPE("Physics::vehicleBatches");
+		_broker->getJobSystem()->parallelFor(nbBatches, 1, [&](size_t begin, size_t end) {
+			for (size_t batch = begin; batch < end; batch++) {
+				PxU32 first = (PxU32)batch * VEHICLES_PER_BATCH;
+				PxU32 nbInBatch = std::min(VEHICLES_PER_BATCH, nbVehicles - first);
+
+				PxVehicleSuspensionRaycasts(gBatchQueries.at(batch), nbInBatch, &vehiclesVector[first], raycastResultsSize, gVehicleSceneQueryData->getRaycastQueryResultBuffer((PxU32)batch));
+				PxVehicleUpdates(fixedDeltaTime, grav, *gFrictionPairs, nbInBatch, &vehiclesVector[first], &gVehicleQueryResults[first], &gVehicleConcurrentUpdates[first]);
+			}
+		});
+	}
 
-		actor->attachShape(*shape);
+	// apply the velocity changes + wake ups to the actors (not thread safe, so all at once afterwards)...
+	{
+		PROFILE_SCOPE("Physics::vehiclePostUpdates");
+		PxVehiclePostUpdates(gVehicleConcurrentUpdates.data(), nbVehicles, vehiclesVector.data());
+	}
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle5>(actor);
-		break;
+	for (PxU32 i = 0; i < nbVehicles; i++) {
+		shoppingCartPlayers.at(i)->_shoppingCartBase->setIsAirborne(vehiclesVector.at(i)->getRigidDynamicActor()->isSleeping() ? false : PxVehicleIsInAir(gVehicleQueryResults.at(i)));
 	}
-	case EntityTypes::OBSTACLE6:
-	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE6_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE6_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
 
-		actor->attachShape(*shape);
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle6>(actor);
-		break;
-	}
-	case EntityTypes::OBSTACLE7:
+	// clear collision vectors...
+	gCollisionEvents.reset();
+
+	_pvdCapture->onStepBegin(); // an armed capture has to connect before the step it starts at (NOTE: outside the simulate timing, connecting opens a file)
+
+	// Scene update...
 	{
-		std::vector<PxVec3> verts = castVectorOfGLMVec4ToVectorOfPxVec3(_broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE7_GEO)->verts);
-		std::vector<PxU32> indices = _broker->getLoadingManager()->getGeometry(GeometryTypes::OBSTACLE7_GEO)->vIndex;
-		PxMaterial *material = gPhysics->createMaterial(0.5f, 0.5f, 0.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_OBSTACLE, CollisionFlags::COLLISION_FLAG_OBSTACLE_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createTriMeshCollider(verts, indices, material, simData, qryData, isExclusive, shapeFlags);
+		PROFILE_SCOPE("Physics::simulate");
+		BenchmarkTimer timer(_broker->_benchmarkResults != nullptr ? &_broker->_benchmarkResults->_simulateMillis : nullptr);
+		_activeScene->_physxScene->simulate(fixedDeltaTime);
+		_isStepInFlight = true;
+	}
+}
 
-		// ACTOR...
-		PxRigidStatic *actor = gPhysics->createRigidStatic(transform);
-		actor->setName(name);
 
-		actor->attachShape(*shape);
 
-		// ENTITY...
-		entity = std::make_shared<Obstacle7>(actor);
-		break;
-	}
-	case EntityTypes::MILK:
+// waits for the step started by beginStep() and then runs all the post-simulation work (collision events, anti-flip, pose snapshots)
+void PhysicsManager::endStep() {
+	if (!_isStepInFlight) return;
+	PROFILE_SCOPE("Physics::endStep");
+
 	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+		PROFILE_SCOPE("Physics::fetchResults");
+		BenchmarkTimer timer(_broker->_benchmarkResults != nullptr ? &_broker->_benchmarkResults->_fetchResultsMillis : nullptr);
+		_activeScene->_physxScene->fetchResults(true); // wait for results to come in before moving on to next system
+		_isStepInFlight = false;
+	}
+	_pvdCapture->onStepEnd(); // bounded captures stop here
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &shoppingCartPlayers = _activeScene->getAllShoppingCartPlayers();
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+	// RESET HIT FLAG...
+	for (const std::shared_ptr<ShoppingCartPlayer> &shoppingCartPlayer : shoppingCartPlayers) {
+		shoppingCartPlayer->_shoppingCartBase->_wasHitFrameTimer--;
+		if (shoppingCartPlayer->_shoppingCartBase->_wasHitFrameTimer < 0) shoppingCartPlayer->_shoppingCartBase->_wasHitFrameTimer = 0;
+	}
+
+	// now that fetchResults() has cached all collision events in the 2 vectors, call the proper events
+	{
+		PROFILE_SCOPE("Physics::collisionDispatch");
+		for (const ContactCollision &collision : gCollisionEvents.getContactCollisions()) {
+			if (collision._collisionType == ContactCollision::ContactCollisionTypes::ENTER) {
+				collision._caller->onCollisionEnter(collision._localShape, collision._otherShape, collision._otherEntity, gCollisionEvents.getContacts(collision), collision._nbContacts);
+			}
+			else {
+				collision._caller->onCollisionExit(collision._localShape, collision._otherShape, collision._otherEntity, gCollisionEvents.getContacts(collision), collision._nbContacts);
+			}
+		}
 
-		actor->attachShape(*shape);
+		for (const TriggerCollision &collision : gCollisionEvents.getTriggerCollisions()) {
+			if (collision._collisionType == TriggerCollision::TriggerCollisionTypes::ENTER) {
+				collision._caller->onTriggerEnter(collision._localShape, collision._otherShape, collision._otherEntity);
+			}
+			else {
+				collision._caller->onTriggerExit(collision._localShape, collision._otherShape, collision._otherEntity);
+			}
+		}
 
-		// ENTITY...
-		entity = std::make_shared<Milk>(actor);
-		break;
+		collectPickups();
 	}
-	case EntityTypes::WATER:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+	// OUT OF BOUNDS...
+	// pickups that left the world get destroyed (recycled if pooled) so they don't screw up the spawn counts, nothing else is expected to ever get out
+	for (Entity *entity : gOutOfBoundsEntities) {
+		if (entity->getDestroyFlag()) continue;
+		if (entity->getComponent(ComponentTypes::PICKUP_SCRIPT) != nullptr) {
+			entity->destroy();
+		}
+		else {
+			std::cout << "WARNING: " << (entity->_actor->getName() != nullptr ? entity->_actor->getName() : "unnamed actor") << " left the world bounds" << std::endl;
+		}
+	}
+	gOutOfBoundsEntities.clear();
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+	// ANTI-FLIP OVER...
+	// ~~~~~~NOTE: should this be moved to before simulate() ???????
+	for (const std::shared_ptr<ShoppingCartPlayer> &cart : shoppingCartPlayers) {
+		PxVec3 cartPos = cart->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
+		PxQuat cartRot = cart->_actor->is<PxRigidDynamic>()->getGlobalPose().q;
 
-		actor->attachShape(*shape);
+		PxQuat clampedRot(glm::clamp(cartRot.x, -0.3f, 0.3f), cartRot.y, glm::clamp(cartRot.z, -0.3f, 0.3f), cartRot.w);
+		clampedRot = clampedRot.getNormalized();
 
-		// ENTITY...
-		entity = std::make_shared<Water>(actor);
-		break;
+		cart->_actor->is<PxRigidDynamic>()->setGlobalPose(PxTransform(cartPos, clampedRot));
 	}
-	case EntityTypes::COLA:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+	// RENDER INTERPOLATION POSE BUFFERS...
+	// only the actors that were awake this step can have moved (statics + sleeping actors keep prev == curr)
+	// NOTE: carts always get a snapshot since the anti-flip above can move them after the fact
+	for (const std::shared_ptr<ShoppingCartPlayer> &cart : shoppingCartPlayers) {
+		cart->snapshotPose();
+	}
 
-		actor->attachShape(*shape);
+	PxU32 nbActiveActors = 0;
+	PxActor **activeActors = _activeScene->_physxScene->getActiveActors(nbActiveActors);
+	for (PxU32 i = 0; i < nbActiveActors; i++) {
+		Entity *entity = static_cast<Entity*>(activeActors[i]->userData);
+		if (entity == nullptr || entity->getTag() == EntityTypes::SHOPPING_CART_PLAYER) continue;
 
-		// ENTITY...
-		entity = std::make_shared<Cola>(actor);
-		break;
+		// actors that just fell asleep won't be active next step, so settle them now (they're barely moving by the time they sleep)...
+		PxRigidDynamic *dynamic = activeActors[i]->is<PxRigidDynamic>();
+		if (dynamic != nullptr && dynamic->isSleeping()) entity->resetPoseHistory();
+		else entity->snapshotPose();
 	}
-	case EntityTypes::APPLE:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+}
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
 
-		actor->attachShape(*shape);
+void PhysicsManager::cleanup() {
+	delete _pvdCapture; // finishes a running capture file
+	_pvdCapture = nullptr;
+	delete _prefabTable;
+	_prefabTable = nullptr;
+	delete _cookedMeshCache; // NOTE: after cleanupScene1(), the shapes hold references to the meshes
+	_cookedMeshCache = nullptr;
+}
 
-		// ENTITY...
-		entity = std::make_shared<Apple>(actor);
-		break;
-	}
-	case EntityTypes::WATERMELON:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+// offline step (--cook-collision), see physics/cookedmeshcache.h
+bool PhysicsManager::cookStaticMeshes() {
+	return _cookedMeshCache->cookAll();
+}
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
 
-		actor->attachShape(*shape);
 
-		// ENTITY...
-		entity = std::make_shared<Watermelon>(actor);
-		break;
-	}
-	case EntityTypes::BANANA:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+std::shared_ptr<Entity> PhysicsManager::instantiateEntity(EntityTypes type, physx::PxTransform transform, const char *name) {
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+	std::shared_ptr<Entity> entity;
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+	switch (type) {
+	case EntityTypes::SHOPPING_CART_PLAYER:
+	{
+		// SHAPES / ACTOR...
+		VehicleShoppingCart *shoppingCartBase = new VehicleShoppingCart(gPhysics, gCooking);
+		shoppingCartBase->_vehicle4W->getRigidDynamicActor()->setGlobalPose(transform);
+		shoppingCartBase->_vehicle4W->getRigidDynamicActor()->setName(name);
 
-		actor->attachShape(*shape);
+		// DEFAULT: NON-KINEMATIC DYNAMIC (GRAVITY ENABLED)
 
 		// ENTITY...
-		entity = std::make_shared<Banana>(actor);
+		entity = std::make_shared<ShoppingCartPlayer>(shoppingCartBase);
 		break;
 	}
-	case EntityTypes::CARROT:
+	default:
 	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+		// everything else is built from its prefab (shared material + shape, see physics/prefabtable.h)...
+		const Prefab *prefab = _prefabTable->getPrefab(type);
+		if (prefab == nullptr) {
+			entity = nullptr;
+			break;
+		}
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+		// pickups come out of the pool (reused or freshly created)...
+		if (_pickupPool != nullptr && _pickupPool->isPooled(type)) {
+			entity = _pickupPool->acquire(type, transform, name);
+			break;
+		}
 
 		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
+		PxRigidActor *actor = nullptr;
+		if (prefab->_desc->_isStatic) {
+			actor = gPhysics->createRigidStatic(transform);
+		}
+		else {
+			actor = gPhysics->createRigidDynamic(transform);
+			actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+		}
 		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
 
-		actor->attachShape(*shape);
+		actor->attachShape(*prefab->_shape);
 
 		// ENTITY...
-		entity = std::make_shared<Carrot>(actor);
+		entity = prefab->_desc->_createEntity(actor);
 		break;
 	}
-	case EntityTypes::EGGPLANT:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
-
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+	}
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+	if (entity != nullptr) {
+		// NOTE: add to the scene first, so the entity's pooled state exists by the time onSpawn() runs
+		_activeScene->addEntity(entity);
 
-		actor->attachShape(*shape);
+		// pooled pickups always come out as resting triggers (see setPickupSolid())...
+		if (_pickupGrid != nullptr && _pickupPool != nullptr && _pickupPool->isPooled(type)) {
+			_pickupGrid->insert(entity.get(), transform.p, _prefabTable->getPrefab(type)->_desc->_radius);
+		}
 
-		// ENTITY...
-		entity = std::make_shared<Eggplant>(actor);
-		break;
+		// call ONSPAWN() if entity has a behaviour script component...
+		Component *comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
+		if (comp != nullptr) {
+			BehaviourScript *script = static_cast<BehaviourScript*>(comp);
+			script->onSpawn();
+		}
 	}
-	case EntityTypes::BROCCOLI:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+	return entity;
+}
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
 
-		actor->attachShape(*shape);
+// PICKUP COLLECTION...
+// every cart's box gets checked against the pickup grid, then the candidates get an exact shape vs shape overlap test against the cart's shapes,
+// same pairs PhysX used to report (filter data has to match, trigger shapes like the bash volume never count)
+// NOTE: PhysX only reported the first touch, this fires every step the shapes overlap, but every pickup destroys itself on the first call anyway
+void PhysicsManager::collectPickups() {
+	PROFILE_SCOPE("Physics::collectPickups");
+	static const PxU32 MAX_CART_SHAPES = 8; // chassis + 4 wheels + bash volume
 
-		// ENTITY...
-		entity = std::make_shared<Broccoli>(actor);
-		break;
-	}
-	case EntityTypes::MYSTERY_BAG:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+	for (const std::shared_ptr<ShoppingCartPlayer> &cart : _activeScene->getAllShoppingCartPlayers()) {
+		if (cart->getDestroyFlag()) continue;
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+		PxRigidDynamic *cartActor = cart->_actor->is<PxRigidDynamic>();
+		_pickupGrid->queryOverlaps(cartActor->getWorldBounds(), gPickupOverlaps);
+		if (gPickupOverlaps.empty()) continue;
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+		PxShape *cartShapes[MAX_CART_SHAPES];
+		PxU32 nbCartShapes = cartActor->getShapes(cartShapes, MAX_CART_SHAPES);
+		const PxTransform cartPose = cartActor->getGlobalPose();
 
-		actor->attachShape(*shape);
+		for (Entity *pickup : gPickupOverlaps) {
+			if (pickup->getDestroyFlag()) continue; // PREVENTS MULTIPLE CARTS PICKING THIS UP IN SAME STEP
 
-		// ENTITY...
-		entity = std::make_shared<MysteryBag>(actor);
-		break;
-	}
-	case EntityTypes::COOKIE:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+			PxShape *pickupShape = nullptr;
+			PxRigidActor *pickupActor = pickup->_actor->is<PxRigidActor>();
+			if (pickupActor->getShapes(&pickupShape, 1) == 0) continue;
+			const PxTransform pickupPose = pickupActor->getGlobalPose() * pickupShape->getLocalPose();
+			const PxFilterData pickupFilterData = pickupShape->getSimulationFilterData();
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
+			for (PxU32 i = 0; i < nbCartShapes; i++) {
+				PxShape *cartShape = cartShapes[i];
+				if (!(cartShape->getFlags() & PxShapeFlag::eSIMULATION_SHAPE)) continue;
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+				const PxFilterData cartFilterData = cartShape->getSimulationFilterData();
+				if ((0 == (pickupFilterData.word0 & cartFilterData.word1)) || (0 == (cartFilterData.word0 & pickupFilterData.word1))) continue;
 
-		actor->attachShape(*shape);
+				if (!PxGeometryQuery::overlap(pickupShape->getGeometry().any(), pickupPose, cartShape->getGeometry().any(), cartPose * cartShape->getLocalPose())) continue;
 
-		// ENTITY...
-		entity = std::make_shared<Cookie>(actor);
-		break;
+				Component *comp = pickup->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
+				if (comp != nullptr) static_cast<BehaviourScript*>(comp)->onTriggerEnter(pickupShape, cartShape, cart.get());
+				break;
+			}
+		}
 	}
-	case EntityTypes::SPARE_CHANGE:
-	{
-		PxReal radius = 2.5f;
-		PxMaterial *material = gPhysics->createMaterial(1.0f, 1.0f, 1.0f);
-		PxFilterData simData(CollisionFlags::COLLISION_FLAG_PICKUP, CollisionFlags::COLLISION_FLAG_PICKUP_AGAINST, 0, 0);
-		PxFilterData qryData;
-		setupNonDrivableSurface(qryData);
-		bool isExclusive = true;
-		PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eTRIGGER_SHAPE | PxShapeFlag::eVISUALIZATION;
+}
 
-		// SHAPE...
-		PxShape *shape = createSphereCollider(radius, material, simData, qryData, isExclusive, shapeFlags);
 
-		// ACTOR...
-		PxRigidDynamic *actor = gPhysics->createRigidDynamic(transform);
-		actor->setName(name);
-		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+// swaps a pickup between its shared trigger shape and its shared solid shape (NOTE: shared shapes can't have their flags changed per actor)
+// a trigger pickup is also kinematic: it never moves, so the solver skips it and it falls asleep (its spin/bob only exists in the renderer)
+// NOTE: velocities have to be cleared BEFORE going back to a trigger, PhysX rejects velocity calls on kinematic bodies
+void PhysicsManager::setPickupSolid(Entity *pickup, bool isSolid) {
+	const Prefab *prefab = _prefabTable->getPrefab(pickup->getTag());
+	if (prefab == nullptr || prefab->_solidShape == nullptr) return;
 
-		actor->attachShape(*shape);
+	PxRigidDynamic *actor = pickup->_actor->is<PxRigidDynamic>();
+	PxShape *targetShape = isSolid ? prefab->_solidShape : prefab->_shape;
+	PxShape *currentShape = nullptr;
+	actor->getShapes(&currentShape, 1);
 
-		// ENTITY...
-		entity = std::make_shared<SpareChange>(actor);
-		break;
-	}
-	default:
-		entity = nullptr;
-		break;
+	// the pickup grid only holds resting pickups (NOTE: also refreshes the position of one that's already resting, e.g. after a snapshot restore)...
+	if (_pickupGrid != nullptr) {
+		if (isSolid) _pickupGrid->remove(pickup);
+		else _pickupGrid->insert(pickup, actor->getGlobalPose().p, prefab->_desc->_radius);
 	}
 
-	if (entity != nullptr) {
-		// call ONSPAWN() if entity has a behaviour script component...
-		std::shared_ptr<Component> comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-		if (comp != nullptr) {
-			std::shared_ptr<BehaviourScript> script = std::static_pointer_cast<BehaviourScript>(comp);
-			script->onSpawn();
-		}
-		_activeScene->addEntity(entity);
-	}
+	if (currentShape == targetShape) return;
 
-	return entity;
+	if (currentShape != nullptr) actor->detachShape(*currentShape);
+	actor->attachShape(*targetShape);
+	actor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, !isSolid);
+
+	ComponentPools *pools = _activeScene->_componentPools;
+	uint32_t pickupIndex = pools->getPickupIndex(pickup->_handle);
+	if (pickupIndex != INVALID_POOL_INDEX) pools->_pickups._isSolid[pickupIndex] = isSolid;
 }
 
 
@@ -1182,23 +1295,7 @@ PxShape* PhysicsManager::createBoxCollider(PxReal xSize, PxReal ySize, PxReal zS
 }
 
 
-PxShape* PhysicsManager::createTriMeshCollider(const std::vector<PxVec3>& verts, const std::vector<PxU32>& indices, PxMaterial *material, const PxFilterData& simData, const PxFilterData& qryData, bool isExclusive, PxShapeFlags shapeFlags) {
-	PxTriangleMeshDesc meshDesc;
-	meshDesc.points.count = verts.size();
-	meshDesc.points.stride = sizeof(PxVec3);
-	meshDesc.points.data = verts.data(); 
-
-	meshDesc.triangles.count = indices.size() / 3;
-	meshDesc.triangles.stride = 3 * sizeof(PxU32);
-	meshDesc.triangles.data = indices.data();
-
-	PxTriangleMesh *triMesh = nullptr;
-	PxDefaultMemoryOutputStream buf;
-	if (gCooking->cookTriangleMesh(meshDesc, buf)) {
-		PxDefaultMemoryInputData id(buf.getData(), buf.getSize());
-		triMesh = gPhysics->createTriangleMesh(id);
-	}
-
+PxShape* PhysicsManager::createTriMeshCollider(PxTriangleMesh *triMesh, PxMaterial *material, const PxFilterData& simData, const PxFilterData& qryData, bool isExclusive, PxShapeFlags shapeFlags) {
 	PxShape *shape = gPhysics->createShape(PxTriangleMeshGeometry(triMesh), *material, isExclusive, shapeFlags);
 
 	shape->setQueryFilterData(qryData);
@@ -4,6 +4,7 @@
 #include "PxPhysicsAPI.h"
 #include <memory>
 #include "core/gamescene.h"
+#include "physics/pvdcapture.h"
 
 #include "objects/shoppingcartplayer.h"
 #include "objects/ground.h"
@@ -30,6 +31,13 @@
 
 
 class Broker;
+class SnapshotWriter;
+class SnapshotReader;
+class CookedMeshCache;
+class PrefabTable;
+class RaycastBatch;
+class PickupActorPool;
+class PickupGrid;
 
 
 
@@ -88,74 +96,44 @@ public:
 	void onWake(physx::PxActor **actors, physx::PxU32 count) override;
 };
 
-
-
-
-struct ContactCollision {
-
-	enum ContactCollisionTypes {
-		ENTER,
-		EXIT
-	};
-
-	ContactCollision(ContactCollisionTypes collisionType, std::shared_ptr<BehaviourScript> caller, physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity, physx::PxContactPairPoint *contacts, physx::PxU32 nbContacts) 
-		: _collisionType(collisionType), _caller(caller), _localShape(localShape), _otherShape(otherShape), _otherEntity(otherEntity), _contacts(contacts), _nbContacts(nbContacts)
-	{
-
-	}
-	
-	ContactCollisionTypes _collisionType;
-	std::shared_ptr<BehaviourScript> _caller = nullptr;
-	physx::PxShape *_localShape = nullptr;
-	physx::PxShape *_otherShape = nullptr;
-	Entity *_otherEntity = nullptr;
-	physx::PxContactPairPoint *_contacts = nullptr;
-	physx::PxU32 _nbContacts;
-
-};
-
-
-
-struct TriggerCollision {
-
-	enum TriggerCollisionTypes {
-		ENTER,
-		EXIT
-	};
-
-	TriggerCollision(TriggerCollisionTypes collisionType, std::shared_ptr<BehaviourScript> caller, physx::PxShape *localShape, physx::PxShape *otherShape, Entity *otherEntity)
-		: _collisionType(collisionType), _caller(caller), _localShape(localShape), _otherShape(otherShape), _otherEntity(otherEntity)
-	{
-
-	}
-
-	TriggerCollisionTypes _collisionType;
-	std::shared_ptr<BehaviourScript> _caller = nullptr;
-	physx::PxShape *_localShape = nullptr;
-	physx::PxShape *_otherShape = nullptr;
-	Entity *_otherEntity = nullptr;
-
+// gets told by the MBP broadphase when a shape leaves every broadphase region (see WORLD_BOUNDS in physicsmanager.cpp)...
+class CustomBroadPhaseCallback : public physx::PxBroadPhaseCallback {
+public:
+	void onObjectOutOfBounds(physx::PxShape &shape, physx::PxActor &actor) override;
+	void onObjectOutOfBounds(physx::PxAggregate &aggregate) override;
 };
 
 
 
 
-
-
-
 class PhysicsManager {
 public:
 	PhysicsManager(Broker *broker);
 	virtual ~PhysicsManager();
 	void init();
-	void updateSeconds(double fixedDeltaTime);
+	void updateSeconds(double fixedDeltaTime); // = beginStep() + endStep()
+	void beginStep(double fixedDeltaTime);
+	void endStep();
+	bool isStepInFlight() { return _isStepInFlight; }
 	void cleanup();
+	bool cookStaticMeshes(); // writes the cooked collision blobs for the static map (returns false if any failed)
 
 	void loadScene1(int numPlayers);
+	void restartScene1(int numPlayers); // warm restart (see physicsmanager.cpp)
 	void cleanupScene1();
+	bool hasActiveScene() { return _activeScene != nullptr; }
 
 	std::shared_ptr<Entity> instantiateEntity(EntityTypes type, physx::PxTransform transform, const char *name);
+	void setPickupSolid(Entity *pickup, bool isSolid); // solid = falls/bounces like a rigid body, otherwise it's a trigger
+
+	// SNAPSHOTS (see core/snapshot.h)...
+	// every dynamic entity's rigid body state + cart/player/pickup state, restored in place on the existing actors
+	void writeSnapshot(SnapshotWriter &writer);
+	bool readSnapshot(SnapshotReader &reader);
+	std::shared_ptr<Entity> resolveSnapshotHandle(EntityHandle handle); // maps a handle stored in the last restored snapshot to the live entity (nullptr if it's gone)
 	std::shared_ptr<GameScene> getActiveScene() { return _activeScene; }
+	PickupActorPool* getPickupPool() { return _pickupPool; } // nullptr without an active scene
+	RaycastBatch* getAIRays() { return _aiRays; } // this step's bot navigation rays (already run by the time the fixedUpdate() pass starts)
 
 
 	physx::PxShape** getAllShapes();
@@ -165,15 +143,46 @@ public:
 	// returns true if any touching/blocking hit was found
 	bool raycast(const physx::PxVec3 &origin, const physx::PxVec3 &unitDir, const physx::PxReal distance, physx::PxRaycastCallback &hitCall);
 
+	// PIPELINED MODE: the last physics step of each frame keeps simulating while the frame gets rendered, results get fetched at the start of the next frame
+	// NOTE: rendering must only read the entity pose buffers (not live actor state) while a step is in flight
+	bool _pipelined = false;
+
+	// CARTS...
+	static const int DEFAULT_NB_VEHICLES = 6; // 1 per hand placed spawn point
+	static const int MAX_NB_VEHICLES = 64;
+	int _nbVehicles = DEFAULT_NB_VEHICLES; // (--carts N) humans + bots, only read when a scene gets (cold) loaded
+
+	// PVD (see physics/pvdcapture.h)...
+	PvdCaptureSettings _pvdSettings; // (--pvd-host, --pvd-capture, --pvd-frames, --pvd-capture-from, --pvd-flags) only read in init()
+	PvdCapture* getPvdCapture() { return _pvdCapture; } // nullptr before init()
+
 private:
 	Broker *_broker = nullptr;
 
+	bool _isStepInFlight = false;
+
+	CookedMeshCache *_cookedMeshCache = nullptr; // static map triangle meshes, kept across matches
+	PrefabTable *_prefabTable = nullptr; // shared materials/shapes for instantiateEntity(), kept across matches
+	PvdCapture *_pvdCapture = nullptr; // owns the PxPvd, lives for the whole program
+	PickupActorPool *_pickupPool = nullptr; // parked pickup actors, lives as long as the active scene's PxScene
+	PickupGrid *_pickupGrid = nullptr; // resting pickups by position + type, lives as long as the active scene
+	RaycastBatch *_aiRays = nullptr; // every bot's navigation rays, run as 1 batch per step (lives as long as the active scene's PxScene)
+
 	std::shared_ptr<GameScene> _activeScene = nullptr;
 
+	// entities that had already been removed when a snapshot got restored have to be re-instantiated (new handle), so keep track of old -> new for the AI's references
+	std::vector<std::pair<EntityHandle, std::shared_ptr<Entity>>> _snapshotRemap;
+
+	std::vector<physx::PxTransform> getShuffledVehicleSpawnTransforms(); // hand placed spots for up to 6 carts, checked spots on generated rings past that
+	bool isSpawnClear(const physx::PxTransform &transform, const physx::PxBoxGeometry &box, physx::PxReal boundsMargin); // inside WORLD_BOUNDS and not overlapping static geometry
+	void assignPlayer(PlayerScript *script, int vehicleIndex, int numPlayers); // sets human/bot + input ID from the cart's index
+	void collectPickups(); // cart vs resting pickup overlaps (through the pickup grid), calls the pickups' onTriggerEnter()
+	void discardStepInFlight(); // waits for an in-flight step and throws away everything its callbacks recorded (scene about to be reset/released, no endStep() for it)
+
 
 	physx::PxShape* createSphereCollider(physx::PxReal radius, physx::PxMaterial *material, const physx::PxFilterData& simData, const physx::PxFilterData& qryData, bool isExclusive, physx::PxShapeFlags shapeFlags);
 	physx::PxShape* createBoxCollider(physx::PxReal xSize, physx::PxReal ySize, physx::PxReal zSize, physx::PxMaterial *material, const physx::PxFilterData& simData, const physx::PxFilterData& qryData, bool isExclusive, physx::PxShapeFlags shapeFlags);
-	physx::PxShape* createTriMeshCollider(const std::vector<physx::PxVec3>& verts, const std::vector<physx::PxU32>& indices, physx::PxMaterial *material, const physx::PxFilterData& simData, const physx::PxFilterData& qryData, bool isExclusive, physx::PxShapeFlags shapeFlags);
+	physx::PxShape* createTriMeshCollider(physx::PxTriangleMesh *triMesh, physx::PxMaterial *material, const physx::PxFilterData& simData, const physx::PxFilterData& qryData, bool isExclusive, physx::PxShapeFlags shapeFlags);
 };
 
 
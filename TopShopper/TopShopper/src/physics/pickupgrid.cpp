@@ -0,0 +1,186 @@
+#include "pickupgrid.h"
+#include <algorithm>
+
+using namespace physx;
+
+
+static const uint32_t INVALID_GRID_INDEX = UINT32_MAX;
+
+
+
+PickupGrid::PickupGrid(const PxBounds3 &worldBounds, PxReal cellSize)
+	: _origin(worldBounds.minimum), _cellSize(cellSize), _invCellSize(1.0f / cellSize)
+{
+	PxVec3 extents = worldBounds.getDimensions();
+	_nbCellsX = std::max(1, (int)PxCeil(extents.x * _invCellSize));
+	_nbCellsZ = std::max(1, (int)PxCeil(extents.z * _invCellSize));
+	_cells.resize(_nbCellsX * _nbCellsZ);
+
+	for (uint32_t &nb : _nbOfType) nb = 0;
+}
+
+
+
+void PickupGrid::insert(Entity *entity, const PxVec3 &pos, PxReal radius) {
+	uint32_t slot = entity->_handle._slot;
+	if (slot >= _sparse.size()) _sparse.resize(slot + 1, INVALID_GRID_INDEX);
+
+	int cellX, cellZ;
+	getCellCoords(pos, cellX, cellZ);
+	uint32_t cellIndex = getCellIndex(cellX, cellZ);
+
+	uint32_t index = _sparse[slot];
+	if (index != INVALID_GRID_INDEX) {
+		// ALREADY IN HERE: just move it (between cells if it has to)...
+		_positions[index] = pos;
+		_radii[index] = radius;
+		if (_cellIndices[index] == cellIndex) return;
+
+		std::vector<uint32_t> &oldCell = _cells[_cellIndices[index]];
+		uint32_t cellSlot = _cellSlots[index];
+		oldCell[cellSlot] = oldCell.back();
+		_cellSlots[oldCell[cellSlot]] = cellSlot;
+		oldCell.pop_back();
+
+		_cellIndices[index] = cellIndex;
+		_cellSlots[index] = (uint32_t)_cells[cellIndex].size();
+		_cells[cellIndex].push_back(index);
+		return;
+	}
+
+	index = (uint32_t)_entities.size();
+	_sparse[slot] = index;
+	_entities.push_back(entity);
+	_positions.push_back(pos);
+	_radii.push_back(radius);
+	_types.push_back(entity->getTag());
+	_cellIndices.push_back(cellIndex);
+	_cellSlots.push_back((uint32_t)_cells[cellIndex].size());
+	_cells[cellIndex].push_back(index);
+
+	_nbOfType[entity->getTag()]++;
+	if (radius > _maxRadius) _maxRadius = radius;
+}
+
+
+void PickupGrid::remove(Entity *entity) {
+	uint32_t slot = entity->_handle._slot;
+	if (slot >= _sparse.size() || _sparse[slot] == INVALID_GRID_INDEX) return;
+	uint32_t index = _sparse[slot];
+
+	// OUT OF ITS CELL (swap and pop)...
+	std::vector<uint32_t> &cell = _cells[_cellIndices[index]];
+	uint32_t cellSlot = _cellSlots[index];
+	cell[cellSlot] = cell.back();
+	_cellSlots[cell[cellSlot]] = cellSlot;
+	cell.pop_back();
+
+	_nbOfType[_types[index]]--;
+
+	// OUT OF THE DENSE ROWS (swap and pop, then point the moved row's cell + sparse entry at its new index)...
+	uint32_t lastIndex = (uint32_t)_entities.size() - 1;
+	if (index != lastIndex) {
+		_entities[index] = _entities[lastIndex];
+		_positions[index] = _positions[lastIndex];
+		_radii[index] = _radii[lastIndex];
+		_types[index] = _types[lastIndex];
+		_cellIndices[index] = _cellIndices[lastIndex];
+		_cellSlots[index] = _cellSlots[lastIndex];
+
+		_cells[_cellIndices[index]][_cellSlots[index]] = index;
+		_sparse[_entities[index]->_handle._slot] = index;
+	}
+	_entities.pop_back();
+	_positions.pop_back();
+	_radii.pop_back();
+	_types.pop_back();
+	_cellIndices.pop_back();
+	_cellSlots.pop_back();
+
+	_sparse[slot] = INVALID_GRID_INDEX;
+}
+
+
+void PickupGrid::clear() {
+	for (std::vector<uint32_t> &cell : _cells) cell.clear();
+	_entities.clear();
+	_positions.clear();
+	_radii.clear();
+	_types.clear();
+	_cellIndices.clear();
+	_cellSlots.clear();
+	std::fill(_sparse.begin(), _sparse.end(), INVALID_GRID_INDEX);
+	for (uint32_t &nb : _nbOfType) nb = 0;
+	_maxRadius = 0.0f;
+}
+
+
+
+void PickupGrid::queryOverlaps(const PxBounds3 &bounds, std::vector<Entity*> &overlaps) {
+	overlaps.clear();
+	if (_entities.empty()) return;
+
+	int minX, minZ, maxX, maxZ;
+	getCellCoords(bounds.minimum - PxVec3(_maxRadius), minX, minZ);
+	getCellCoords(bounds.maximum + PxVec3(_maxRadius), maxX, maxZ);
+
+	for (int z = minZ; z <= maxZ; z++) {
+		for (int x = minX; x <= maxX; x++) {
+			for (uint32_t index : _cells[getCellIndex(x, z)]) {
+				// sphere vs box: closest point of the box to the centre...
+				const PxVec3 &pos = _positions[index];
+				PxVec3 closest = pos.maximum(bounds.minimum).minimum(bounds.maximum);
+				if ((closest - pos).magnitudeSquared() <= _radii[index] * _radii[index]) overlaps.push_back(_entities[index]);
+			}
+		}
+	}
+}
+
+
+Entity* PickupGrid::findNearest(const PxVec3 &pos, EntityTypes type, PxReal &distance) {
+	distance = PX_MAX_F32;
+	if (_nbOfType[type] == 0) return nullptr;
+
+	int centreX, centreZ;
+	getCellCoords(pos, centreX, centreZ);
+
+	uint32_t best = INVALID_GRID_INDEX;
+	PxReal bestDistanceSquared = PX_MAX_F32;
+	int maxRing = std::max(_nbCellsX, _nbCellsZ);
+	for (int ring = 0; ring <= maxRing; ring++) {
+		// only the cells on the border of this ring (the inner ones were done by the previous rings)...
+		for (int z = centreZ - ring; z <= centreZ + ring; z++) {
+			if (z < 0 || z >= _nbCellsZ) continue;
+			bool isBorderRow = (z == centreZ - ring) || (z == centreZ + ring);
+			int step = isBorderRow ? 1 : 2 * ring;
+			for (int x = centreX - ring; x <= centreX + ring; x += step) {
+				if (x < 0 || x >= _nbCellsX) continue;
+				for (uint32_t index : _cells[getCellIndex(x, z)]) {
+					if (_types[index] != type || _entities[index]->getDestroyFlag()) continue;
+					PxReal distanceSquared = (_positions[index] - pos).magnitudeSquared();
+					if (distanceSquared < bestDistanceSquared) {
+						bestDistanceSquared = distanceSquared;
+						best = index;
+					}
+				}
+			}
+		}
+
+		// every cell past this ring is at least ring * cellSize away (in xz alone), so nothing out there can beat it...
+		PxReal ringDistance = ring * _cellSize;
+		if (best != INVALID_GRID_INDEX && bestDistanceSquared <= ringDistance * ringDistance) break;
+	}
+
+	if (best == INVALID_GRID_INDEX) return nullptr;
+	distance = PxSqrt(bestDistanceSquared);
+	return _entities[best];
+}
+
+
+
+void PickupGrid::getCellCoords(const PxVec3 &pos, int &cellX, int &cellZ) {
+	cellX = (int)PxFloor((pos.x - _origin.x) * _invCellSize);
+	cellZ = (int)PxFloor((pos.z - _origin.z) * _invCellSize);
+	cellX = std::min(std::max(cellX, 0), _nbCellsX - 1);
+	cellZ = std::min(std::max(cellZ, 0), _nbCellsZ - 1);
+}
@@ -0,0 +1,64 @@
+#ifndef PICKUPGRID_H_
+#define PICKUPGRID_H_
+
+#include "PxPhysicsAPI.h"
+#include <vector>
+#include <cstdint>
+#include "objects/entity.h"
+
+
+// DEFINITION:
+// PICKUP GRID (1 per PxScene, owned by the physics manager, hooked into the GameScene)
+// uniform grid over the store floor (xz) holding every RESTING pickup (the kinematic triggers, see PhysicsManager::setPickupSolid()), by position + type:
+//		insert() / remove()	- O(1), instantiateEntity() / setPickupSolid() / GameScene::removeEntity() keep it up to date
+//		queryOverlaps()		- pickups whose sphere touches a box (PhysicsManager::collectPickups() runs this per cart instead of PhysX trigger pairs)
+//		findNearest()		- closest pickup of 1 type, searched ring by ring outwards from the position's cell (AI target search)
+// the pickup state is stored densely (parallel arrays, same sparse set idea as core/componentpools.h: handle slot -> dense index),
+// the cells only hold dense indices, so a query walks a handful of small arrays instead of every pickup in the scene.
+//
+// NOTE: resting pickups never move, so nothing has to be re-bucketed per step (loose/solid pickups aren't in here at all until they land again)
+// NOTE: anything outside the bounds gets clamped into the border cells, it's still found, just less efficiently
+// NOTE: entries are only removed once the entity leaves the scene, so destroy flagged ones can still come back from queryOverlaps() (findNearest() skips them)
+
+
+class PickupGrid {
+public:
+	PickupGrid(const physx::PxBounds3 &worldBounds, physx::PxReal cellSize);
+
+	void insert(Entity *entity, const physx::PxVec3 &pos, physx::PxReal radius); // NOTE: the entity has to be in a scene (keyed by its handle), re-inserting just moves it
+	void remove(Entity *entity); // does nothing if it isn't in here
+	void clear();
+
+	void queryOverlaps(const physx::PxBounds3 &bounds, std::vector<Entity*> &overlaps); // clears overlaps first
+	Entity* findNearest(const physx::PxVec3 &pos, EntityTypes type, physx::PxReal &distance); // nullptr if there's none of that type
+
+	physx::PxU32 getNbPickups() { return (physx::PxU32)_entities.size(); }
+
+private:
+	void getCellCoords(const physx::PxVec3 &pos, int &cellX, int &cellZ); // clamped into the grid
+	uint32_t getCellIndex(int cellX, int cellZ) { return (uint32_t)(cellZ * _nbCellsX + cellX); }
+
+	physx::PxVec3 _origin; // min corner (y unused)
+	physx::PxReal _cellSize = 1.0f;
+	physx::PxReal _invCellSize = 1.0f;
+	int _nbCellsX = 1;
+	int _nbCellsZ = 1;
+
+	std::vector<std::vector<uint32_t>> _cells; // [cellZ * _nbCellsX + cellX] -> dense indices (NOTE: clear() keeps their capacity)
+
+	// DENSE ROWS...
+	std::vector<Entity*> _entities;
+	std::vector<physx::PxVec3> _positions;
+	std::vector<physx::PxReal> _radii;
+	std::vector<EntityTypes> _types;
+	std::vector<uint32_t> _cellIndices; // which cell the row is in
+	std::vector<uint32_t> _cellSlots; // where in that cell's index list
+
+	std::vector<uint32_t> _sparse; // handle slot -> dense index
+	uint32_t _nbOfType[EntityTypes::NUMBER_OF_ENTITY_TYPES]; // findNearest() gives up right away on a type that isn't in here
+	physx::PxReal _maxRadius = 0.0f; // queries grow their cell range by this (rows are bucketed by their centre only)
+};
+
+
+
+#endif // PICKUPGRID_H_
@@ -0,0 +1,203 @@
+#include "pickuppool.h"
+#include "prefabtable.h"
+#include <iostream>
+
+using namespace physx;
+
+
+
+// how many of each type get created up front (the pool still grows past these on a miss)...
+// spare change: 51 spawn points + a coin explosion, groceries: 1 on the map + a few knocked loose from bashed carts
+static const struct {
+	EntityTypes _type;
+	unsigned int _count;
+} PREWARM_COUNTS[] = {
+	{ EntityTypes::SPARE_CHANGE,	64 },
+	{ EntityTypes::MILK,			4 },
+	{ EntityTypes::WATER,			4 },
+	{ EntityTypes::COLA,			4 },
+	{ EntityTypes::APPLE,			4 },
+	{ EntityTypes::WATERMELON,		4 },
+	{ EntityTypes::BANANA,			4 },
+	{ EntityTypes::CARROT,			4 },
+	{ EntityTypes::EGGPLANT,		4 },
+	{ EntityTypes::BROCCOLI,		4 },
+	{ EntityTypes::COOKIE,			2 },
+	{ EntityTypes::MYSTERY_BAG,		1 }
+};
+
+
+static const char* getPooledTypeName(EntityTypes type) {
+	switch (type) {
+		case EntityTypes::SPARE_CHANGE: return "spare change";
+		case EntityTypes::MILK: return "milk";
+		case EntityTypes::WATER: return "water";
+		case EntityTypes::COLA: return "cola";
+		case EntityTypes::APPLE: return "apple";
+		case EntityTypes::WATERMELON: return "watermelon";
+		case EntityTypes::BANANA: return "banana";
+		case EntityTypes::CARROT: return "carrot";
+		case EntityTypes::EGGPLANT: return "eggplant";
+		case EntityTypes::BROCCOLI: return "broccoli";
+		case EntityTypes::COOKIE: return "cookie";
+		case EntityTypes::MYSTERY_BAG: return "mystery bag";
+		default: return "other";
+	}
+}
+
+
+
+PickupActorPool::PickupActorPool(PxPhysics *physics, PxScene *physxScene, PrefabTable *prefabTable)
+	: _physics(physics), _physxScene(physxScene), _prefabTable(prefabTable)
+{
+
+}
+
+
+PickupActorPool::~PickupActorPool() {
+	for (TypePool &pool : _pools) {
+		for (std::shared_ptr<Entity> &entity : pool._parked) {
+			entity->_actor->is<PxRigidActor>()->release(); // also takes it out of the PxScene
+			entity->_actor = nullptr;
+		}
+		pool._parked.clear();
+	}
+}
+
+
+
+void PickupActorPool::prewarm() {
+	for (const auto &prewarmCount : PREWARM_COUNTS) {
+		if (!isPooled(prewarmCount._type)) continue;
+
+		TypePool &pool = _pools[prewarmCount._type];
+		pool._parked.reserve(prewarmCount._count);
+		while (pool._stats._nbCreated < prewarmCount._count) {
+			std::shared_ptr<Entity> entity = createEntity(prewarmCount._type, PxTransform(PxIdentity));
+			park(entity);
+			_physxScene->addActor(*(entity->_actor));
+		}
+	}
+}
+
+
+
+bool PickupActorPool::isPooled(EntityTypes type) {
+	const Prefab *prefab = _prefabTable->getPrefab(type);
+	return prefab != nullptr && !prefab->_desc->_isStatic && prefab->_desc->_isTrigger;
+}
+
+
+std::shared_ptr<Entity> PickupActorPool::acquire(EntityTypes type, const PxTransform &transform, const char *name) {
+	TypePool &pool = _pools[type];
+	const Prefab *prefab = _prefabTable->getPrefab(type);
+
+	// HIT: newest parked entity that nobody else still points to...
+	std::shared_ptr<Entity> entity = nullptr;
+	for (size_t i = pool._parked.size(); i-- > 0;) {
+		if (pool._parked.at(i).use_count() != 1) continue;
+
+		entity = pool._parked.at(i);
+		if (i != pool._parked.size() - 1) pool._parked.at(i) = pool._parked.back();
+		pool._parked.pop_back();
+		break;
+	}
+
+	if (entity != nullptr) {
+		pool._stats._nbHits++;
+
+		// NOTE: velocities can only be set once simulation is enabled again
+		PxRigidDynamic *actor = entity->_actor->is<PxRigidDynamic>();
+		actor->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, false);
+		if (!(actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC)) { // got recycled while it was knocked loose (solid)
+			actor->setLinearVelocity(PxVec3(0.0f, 0.0f, 0.0f));
+			actor->setAngularVelocity(PxVec3(0.0f, 0.0f, 0.0f));
+			actor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
+		}
+		actor->setGlobalPose(transform);
+		actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+		entity->resetDestroyFlag();
+	}
+	else {
+		// MISS: grow the pool...
+		pool._stats._nbMisses++;
+		entity = createEntity(type, transform);
+	}
+
+	entity->_actor->setName(name);
+	entity->_actor->is<PxRigidActor>()->attachShape(*prefab->_shape);
+
+	pool._nbActive++;
+	if (pool._nbActive > pool._stats._peakActive) pool._stats._peakActive = pool._nbActive;
+
+	return entity;
+}
+
+
+void PickupActorPool::recycle(const std::shared_ptr<Entity> &entity) {
+	TypePool &pool = _pools[entity->getTag()];
+	if (pool._nbActive > 0) pool._nbActive--;
+
+	// actor stays in the PxScene...
+	park(entity);
+}
+
+
+
+void PickupActorPool::resetStats() {
+	for (TypePool &pool : _pools) {
+		pool._stats._nbHits = 0;
+		pool._stats._nbMisses = 0;
+		pool._stats._peakActive = pool._nbActive;
+	}
+}
+
+
+PickupPoolStats PickupActorPool::getTotalStats() {
+	PickupPoolStats total;
+	for (TypePool &pool : _pools) {
+		total._nbHits += pool._stats._nbHits;
+		total._nbMisses += pool._stats._nbMisses;
+		total._nbCreated += pool._stats._nbCreated;
+		total._peakActive += pool._stats._peakActive;
+	}
+	return total;
+}
+
+
+void PickupActorPool::printStats() {
+	for (int i = 0; i < EntityTypes::NUMBER_OF_ENTITY_TYPES; i++) {
+		TypePool &pool = _pools[i];
+		if (pool._stats._nbCreated == 0) continue;
+
+		std::cout << "PICKUP POOL: " << getPooledTypeName((EntityTypes)i) << ": size " << pool._stats._nbCreated << ", peak " << pool._stats._peakActive << " active, "
+			<< pool._stats._nbHits << " hits / " << pool._stats._nbMisses << " misses (" << pool._stats.getHitRate() * 100.0 << "% hit rate)" << std::endl;
+	}
+}
+
+
+
+std::shared_ptr<Entity> PickupActorPool::createEntity(EntityTypes type, const PxTransform &transform) {
+	const Prefab *prefab = _prefabTable->getPrefab(type);
+
+	PxRigidDynamic *actor = _physics->createRigidDynamic(transform);
+	actor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true); // resting trigger, not integrated by the solver (see PhysicsManager::setPickupSolid())
+	actor->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+
+	_pools[type]._stats._nbCreated++;
+	return prefab->_desc->_createEntity(actor);
+}
+
+
+void PickupActorPool::park(const std::shared_ptr<Entity> &entity) {
+	PxRigidActor *actor = entity->_actor->is<PxRigidActor>();
+
+	// no shapes = no broadphase / contacts / scene query hits, and no simulation...
+	PxShape *shape = nullptr;
+	while (actor->getShapes(&shape, 1) > 0) {
+		actor->detachShape(*shape);
+	}
+	actor->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, true);
+
+	_pools[entity->getTag()]._parked.push_back(entity);
+}
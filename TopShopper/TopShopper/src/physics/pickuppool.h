@@ -0,0 +1,73 @@
+#ifndef PICKUPPOOL_H_
+#define PICKUPPOOL_H_
+
+#include "PxPhysicsAPI.h"
+#include <memory>
+#include <vector>
+#include "objects/entity.h"
+
+
+class PrefabTable;
+
+
+// DEFINITION:
+// PICKUP ACTOR POOL (1 per PxScene, owned by the physics manager, hooked into the GameScene)
+// spare change / groceries / cookies / mystery bags get spawned and picked up all match long (and coin explosions spawn 12 at once),
+// so instead of creating + releasing a PxRigidDynamic, Entity and PickupScript every time, removed pickups are parked here and reused:
+//		recycle()	- (GameScene::removeEntity) detaches the shape and sets eDISABLE_SIMULATION, the actor stays in the PxScene (no shapes = not in the broadphase or scene queries)
+//		acquire()	- (PhysicsManager::instantiateEntity) re-enables a parked actor at the new pose with the prefab's trigger shape (kinematic), or creates a new one on a miss
+// the pool starts prewarmed (see PREWARM_COUNTS in pickuppool.cpp) and grows to whatever the match peaks at.
+// hits / misses / size get printed at the end of every match (and go into the benchmark results) so the prewarm counts can be sized.
+//
+// NOTE: a parked entity is only reused once nothing else holds a shared_ptr to it (e.g. the AI's spawn point / target bookkeeping still
+// checks getDestroyFlag() on the old pointer), otherwise a stale pointer would suddenly see a live pickup again
+// NOTE: the scripts don't keep any per-spawn state outside the component pools, so they're reused as is
+// NOTE: not to be confused with the PickupPool component pool (core/componentpools.h), which holds the pickups' per-entity data
+
+
+struct PickupPoolStats {
+	unsigned long long _nbHits = 0;
+	unsigned long long _nbMisses = 0;
+	unsigned int _nbCreated = 0; // pool size (prewarmed + grown)
+	unsigned int _peakActive = 0; // most pickups of this type out of the pool at once
+
+	double getHitRate() { return (_nbHits + _nbMisses) > 0 ? (double)_nbHits / (_nbHits + _nbMisses) : 0.0; }
+};
+
+
+
+class PickupActorPool {
+public:
+	PickupActorPool(physx::PxPhysics *physics, physx::PxScene *physxScene, PrefabTable *prefabTable);
+	virtual ~PickupActorPool(); // releases every parked actor
+
+	void prewarm();
+
+	bool isPooled(EntityTypes type);
+	std::shared_ptr<Entity> acquire(EntityTypes type, const physx::PxTransform &transform, const char *name); // entity isn't in the GameScene yet (addEntity() is up to the caller)
+	void recycle(const std::shared_ptr<Entity> &entity); // after it's been taken out of the GameScene's bookkeeping
+
+	void resetStats(); // keeps the sizes, clears hits/misses/peaks
+	PickupPoolStats getTotalStats();
+	void printStats();
+
+private:
+	struct TypePool {
+		std::vector<std::shared_ptr<Entity>> _parked;
+		unsigned int _nbActive = 0;
+		PickupPoolStats _stats;
+	};
+
+	std::shared_ptr<Entity> createEntity(EntityTypes type, const physx::PxTransform &transform);
+	void park(const std::shared_ptr<Entity> &entity);
+
+	physx::PxPhysics *_physics = nullptr;
+	physx::PxScene *_physxScene = nullptr;
+	PrefabTable *_prefabTable = nullptr;
+
+	TypePool _pools[EntityTypes::NUMBER_OF_ENTITY_TYPES];
+};
+
+
+
+#endif // PICKUPPOOL_H_
@@ -0,0 +1,152 @@
+#include "prefabtable.h"
+#include "physicsmanager.h"
+#include "cookedmeshcache.h"
+#include "vehicle/snippetvehiclecommon/SnippetVehicleSceneQuery.h"
+#include <iostream>
+
+using namespace physx;
+
+
+
+template <typename T>
+static std::shared_ptr<Entity> createStaticEntity(PxRigidActor *actor) {
+	return std::make_shared<T>(actor->is<PxRigidStatic>());
+}
+
+template <typename T>
+static std::shared_ptr<Entity> createDynamicEntity(PxRigidActor *actor) {
+	return std::make_shared<T>(actor->is<PxRigidDynamic>());
+}
+
+
+// PREFAB DESCRIPTORS...
+// (type, shape, radius, mesh, static friction, dynamic friction, restitution, collision flag, against, drivable, static, trigger, entity)
+// NOTE: pickups are 2.5 radius trigger spheres (the mesh field is unused for spheres)
+static constexpr PrefabDesc PREFAB_DESCS[] = {
+	// ENVIRONMENT...
+	{ EntityTypes::GROUND,		PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::GROUND_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_GROUND,	COLLISION_FLAG_GROUND_AGAINST,		true,	true,	false,	&createStaticEntity<Ground> },
+	{ EntityTypes::ROOF,		PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::ROOF_GEO,		0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Roof> },
+	{ EntityTypes::OBSTACLE1,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE1_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle1> },
+	{ EntityTypes::OBSTACLE2,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE2_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle2> },
+	{ EntityTypes::OBSTACLE3,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE3_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle3> },
+	{ EntityTypes::OBSTACLE4,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE4_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle4> },
+	{ EntityTypes::OBSTACLE5,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE5_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle5> },
+	{ EntityTypes::OBSTACLE6,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE6_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle6> },
+	{ EntityTypes::OBSTACLE7,	PREFAB_SHAPE_TRI_MESH,	0.0f, GeometryTypes::OBSTACLE7_GEO,	0.5f, 0.5f, 0.0f, COLLISION_FLAG_OBSTACLE,	COLLISION_FLAG_OBSTACLE_AGAINST,	false,	true,	false,	&createStaticEntity<Obstacle7> },
+
+	// PICKUPS...
+	{ EntityTypes::MILK,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::MILK_GEO,			1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Milk> },
+	{ EntityTypes::WATER,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::WATER_GEO,			1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Water> },
+	{ EntityTypes::COLA,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::COLA_GEO,			1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Cola> },
+	{ EntityTypes::APPLE,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::APPLE_GEO,			1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Apple> },
+	{ EntityTypes::WATERMELON,	PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::WATERMELON_GEO,	1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Watermelon> },
+	{ EntityTypes::BANANA,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::BANANA_GEO,		1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Banana> },
+	{ EntityTypes::CARROT,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::CARROT_GEO,		1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Carrot> },
+	{ EntityTypes::EGGPLANT,	PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::EGGPLANT_GEO,		1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Eggplant> },
+	{ EntityTypes::BROCCOLI,	PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::BROCCOLI_GEO,		1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Broccoli> },
+	{ EntityTypes::MYSTERY_BAG,	PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::MYSTERY_BAG_GEO,	1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<MysteryBag> },
+	{ EntityTypes::COOKIE,		PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::COOKIE_GEO,		1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<Cookie> },
+	{ EntityTypes::SPARE_CHANGE,PREFAB_SHAPE_SPHERE,	2.5f, GeometryTypes::SPARE_CHANGE_GEO,	1.0f, 1.0f, 1.0f, COLLISION_FLAG_PICKUP,	COLLISION_FLAG_PICKUP_AGAINST,		false,	false,	true,	&createDynamicEntity<SpareChange> }
+};
+
+
+
+PrefabTable::PrefabTable(PxPhysics *physics, CookedMeshCache *cookedMeshCache)
+	: _physics(physics), _cookedMeshCache(cookedMeshCache)
+{
+	for (const PrefabDesc &desc : PREFAB_DESCS) {
+		_prefabs[desc._type]._desc = &desc;
+	}
+}
+
+
+PrefabTable::~PrefabTable() {
+	release();
+}
+
+
+
+const Prefab* PrefabTable::getPrefab(EntityTypes type) {
+	if (type < 0 || type >= EntityTypes::NUMBER_OF_ENTITY_TYPES) return nullptr;
+
+	Prefab &prefab = _prefabs[type];
+	if (prefab._desc == nullptr) return nullptr;
+	if (prefab._shape == nullptr) buildPrefab(prefab);
+	return prefab._shape != nullptr ? &prefab : nullptr;
+}
+
+
+void PrefabTable::release() {
+	for (Prefab &prefab : _prefabs) {
+		if (prefab._shape != nullptr) prefab._shape->release();
+		if (prefab._solidShape != nullptr) prefab._solidShape->release();
+		prefab._shape = nullptr;
+		prefab._solidShape = nullptr;
+		prefab._material = nullptr;
+	}
+
+	for (PxMaterial *material : _materials) {
+		material->release();
+	}
+	_materials.clear();
+}
+
+
+
+void PrefabTable::buildPrefab(Prefab &prefab) {
+	const PrefabDesc &desc = *prefab._desc;
+
+	prefab._material = getSharedMaterial(desc._staticFriction, desc._dynamicFriction, desc._restitution);
+	prefab._shape = createSharedShape(desc, prefab._material, desc._isTrigger);
+	if (desc._isTrigger) {
+		prefab._solidShape = createSharedShape(desc, prefab._material, false);
+	}
+}
+
+
+PxMaterial* PrefabTable::getSharedMaterial(PxReal staticFriction, PxReal dynamicFriction, PxReal restitution) {
+	for (PxMaterial *material : _materials) {
+		if (material->getStaticFriction() == staticFriction && material->getDynamicFriction() == dynamicFriction && material->getRestitution() == restitution) return material;
+	}
+
+	PxMaterial *material = _physics->createMaterial(staticFriction, dynamicFriction, restitution);
+	_materials.push_back(material);
+	return material;
+}
+
+
+PxShape* PrefabTable::createSharedShape(const PrefabDesc &desc, PxMaterial *material, bool isTrigger) {
+	PxShapeFlags shapeFlags = PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eVISUALIZATION;
+	shapeFlags |= isTrigger ? PxShapeFlag::eTRIGGER_SHAPE : PxShapeFlag::eSIMULATION_SHAPE;
+	bool isExclusive = false;
+
+	PxShape *shape = nullptr;
+	switch (desc._shapeType) {
+		case PrefabShapeTypes::PREFAB_SHAPE_SPHERE:
+			shape = _physics->createShape(PxSphereGeometry(desc._radius), *material, isExclusive, shapeFlags);
+			break;
+		case PrefabShapeTypes::PREFAB_SHAPE_TRI_MESH:
+		{
+			PxTriangleMesh *triMesh = _cookedMeshCache->getTriangleMesh(desc._meshGeometry);
+			if (triMesh == nullptr) {
+				std::cout << "ERROR: prefab " << desc._type << " has no collision mesh" << std::endl;
+				return nullptr;
+			}
+			shape = _physics->createShape(PxTriangleMeshGeometry(triMesh), *material, isExclusive, shapeFlags);
+			break;
+		}
+	}
+
+	PxFilterData simData(desc._collisionFlag, desc._collisionAgainst, 0, 0);
+	PxFilterData qryData;
+	if (desc._isDrivable) {
+		snippetvehicle::setupDrivableSurface(qryData);
+	}
+	else {
+		snippetvehicle::setupNonDrivableSurface(qryData);
+	}
+	shape->setQueryFilterData(qryData);
+	shape->setSimulationFilterData(simData);
+
+	return shape;
+}
@@ -0,0 +1,87 @@
+#ifndef PREFABTABLE_H_
+#define PREFABTABLE_H_
+
+#include "PxPhysicsAPI.h"
+#include <memory>
+#include <vector>
+#include "objects/entity.h"
+#include "loading/loadingmanager.h"
+
+
+class CookedMeshCache;
+
+
+// DEFINITION:
+// PREFAB TABLE (1 per program, owned by the physics manager)
+// every entity type that instantiateEntity() builds from plain PhysX shapes is described by a constexpr PrefabDesc (see the table in prefabtable.cpp).
+// the table turns those into shared PhysX objects once:
+//		materials	- 1 per unique (static friction, dynamic friction, restitution), shared by every prefab that uses it
+//		shapes		- 1 shared (non-exclusive) shape per prefab, with its filter data already set, so spawning is just an actor allocation + attachShape()
+//		pickups get a 2nd shared shape that's solid instead of a trigger (lost items fly as solid bodies until they land, see PhysicsManager::setPickupSolid())
+// the shapes are built the first time a prefab is asked for (the static map ones need the cooked meshes), then kept for the rest of the program.
+//
+// NOTE: shared shapes are attached to many actors, so never change their flags/filter data through an actor (swap to the other shared shape instead)
+// NOTE: PxShape::getActor() returns NULL for shared shapes, get the actor from the pair/hit instead
+
+
+enum PrefabShapeTypes {
+	PREFAB_SHAPE_SPHERE,
+	PREFAB_SHAPE_TRI_MESH
+};
+
+
+struct PrefabDesc {
+	EntityTypes _type;
+	PrefabShapeTypes _shapeType;
+	physx::PxReal _radius; // sphere only
+	GeometryTypes _meshGeometry; // tri mesh only (cooked through the CookedMeshCache)
+
+	// MATERIAL...
+	physx::PxReal _staticFriction;
+	physx::PxReal _dynamicFriction;
+	physx::PxReal _restitution;
+
+	// FILTERING...
+	physx::PxU32 _collisionFlag; // CollisionFlags
+	physx::PxU32 _collisionAgainst;
+	bool _isDrivable; // query filter data (vehicle suspension raycasts)
+
+	bool _isStatic; // PxRigidStatic, otherwise a PxRigidDynamic with gravity disabled
+	bool _isTrigger; // also builds the solid variant shape
+
+	std::shared_ptr<Entity> (*_createEntity)(physx::PxRigidActor *actor);
+};
+
+
+struct Prefab {
+	const PrefabDesc *_desc = nullptr;
+	physx::PxMaterial *_material = nullptr;
+	physx::PxShape *_shape = nullptr;
+	physx::PxShape *_solidShape = nullptr; // triggers only
+};
+
+
+
+class PrefabTable {
+public:
+	PrefabTable(physx::PxPhysics *physics, CookedMeshCache *cookedMeshCache);
+	virtual ~PrefabTable();
+
+	const Prefab* getPrefab(EntityTypes type); // nullptr if the type isn't built from a prefab (e.g. carts)
+	void release(); // NOTE: only once no actor has the shapes attached anymore
+
+private:
+	void buildPrefab(Prefab &prefab);
+	physx::PxMaterial* getSharedMaterial(physx::PxReal staticFriction, physx::PxReal dynamicFriction, physx::PxReal restitution);
+	physx::PxShape* createSharedShape(const PrefabDesc &desc, physx::PxMaterial *material, bool isTrigger);
+
+	physx::PxPhysics *_physics = nullptr;
+	CookedMeshCache *_cookedMeshCache = nullptr;
+
+	Prefab _prefabs[EntityTypes::NUMBER_OF_ENTITY_TYPES];
+	std::vector<physx::PxMaterial*> _materials;
+};
+
+
+
+#endif // PREFABTABLE_H_
@@ -0,0 +1,151 @@
+#include "pvdcapture.h"
+#include <iostream>
+#include <sstream>
+
+using namespace physx;
+
+
+
+PvdCapture::PvdCapture(PxFoundation &foundation, const PvdCaptureSettings &settings)
+	: _settings(settings)
+{
+	#ifdef PVD_ENABLED
+	_pvd = PxCreatePvd(foundation);
+
+	// LIVE (used to always connect to localhost, which stalls on machines without a PVD client)...
+	if (!_settings._host.empty()) {
+		_isLive = connect(PxDefaultPvdSocketTransportCreate(_settings._host.c_str(), 5425, 10));
+		if (_isLive) std::cout << "PVD: connected to " << _settings._host << std::endl;
+		else std::cout << "WARNING: PVD: couldn't connect to " << _settings._host << std::endl;
+	}
+	#endif // PVD_ENABLED
+
+	if (_settings._captureAtStart) {
+		if (_settings._captureFromStep > 0) _isArmed = true;
+		else startCapture();
+	}
+}
+
+
+PvdCapture::~PvdCapture() {
+	stopCapture();
+	if (_isLive) disconnect();
+}
+
+
+
+void PvdCapture::toggleCapture() {
+	if (_isCapturing || _isArmed) {
+		_isArmed = false;
+		stopCapture();
+	}
+	else {
+		startCapture();
+	}
+}
+
+
+void PvdCapture::startCapture() {
+	if (_isCapturing) return;
+	_isArmed = false;
+
+	#ifdef PVD_ENABLED
+	if (_isLive) {
+		std::cout << "WARNING: PVD: can't capture to a file while connected to " << _settings._host << std::endl;
+		return;
+	}
+
+	_currentPath = getCapturePath();
+	if (!connect(PxDefaultPvdFileTransportCreate(_currentPath.c_str()))) {
+		std::cout << "ERROR: PVD: couldn't open " << _currentPath << std::endl;
+		return;
+	}
+
+	_isCapturing = true;
+	_nbCapturedSteps = 0;
+	_nbCaptures++;
+	std::cout << "PVD: capturing to " << _currentPath;
+	if (_settings._nbCaptureSteps > 0) std::cout << " (" << _settings._nbCaptureSteps << " steps)";
+	std::cout << std::endl;
+	#else
+	std::cout << "WARNING: PVD: not compiled in (build with PVD_ENABLED), no capture" << std::endl;
+	#endif // PVD_ENABLED
+}
+
+
+void PvdCapture::stopCapture() {
+	if (!_isCapturing) return;
+
+	disconnect(); // flushes + closes the file
+	_isCapturing = false;
+	std::cout << "PVD: captured " << _nbCapturedSteps << " steps to " << _currentPath << std::endl;
+}
+
+
+
+void PvdCapture::onStepBegin() {
+	if (_isArmed && _nbSteps >= _settings._captureFromStep) startCapture();
+}
+
+
+void PvdCapture::onStepEnd() {
+	_nbSteps++;
+	if (!_isCapturing) return;
+
+	_nbCapturedSteps++;
+	if (_settings._nbCaptureSteps > 0 && _nbCapturedSteps >= _settings._nbCaptureSteps) stopCapture();
+}
+
+
+
+PxPvdInstrumentationFlags PvdCapture::parseFlags(const std::string &flags) {
+	PxPvdInstrumentationFlags parsed;
+	std::stringstream stream(flags);
+	std::string name;
+	while (std::getline(stream, name, ',')) {
+		if (name == "debug") parsed |= PxPvdInstrumentationFlag::eDEBUG;
+		else if (name == "profile") parsed |= PxPvdInstrumentationFlag::ePROFILE;
+		else if (name == "memory") parsed |= PxPvdInstrumentationFlag::eMEMORY;
+		else if (name == "all") parsed |= PxPvdInstrumentationFlag::eALL;
+		else std::cout << "WARNING: PVD: unknown capture flag " << name << std::endl;
+	}
+	return parsed;
+}
+
+
+
+bool PvdCapture::connect(PxPvdTransport *transport) {
+	if (_pvd == nullptr || transport == nullptr) return false;
+
+	PxPvdInstrumentationFlags flags = parseFlags(_settings._flags);
+	if (!flags) flags = PxPvdInstrumentationFlag::eALL; // nothing valid asked for, don't capture an empty file
+
+	if (!_pvd->connect(*transport, flags)) {
+		transport->release();
+		return false;
+	}
+	_transport = transport;
+	return true;
+}
+
+
+void PvdCapture::disconnect() {
+	if (_pvd == nullptr || _transport == nullptr) return;
+
+	_pvd->disconnect();
+	_transport->release();
+	_transport = nullptr;
+	_isLive = false;
+}
+
+
+std::string PvdCapture::getCapturePath() {
+	if (_nbCaptures == 0) return _settings._capturePath;
+
+	// capture.pxd2 -> capture_1.pxd2...
+	std::string path = _settings._capturePath;
+	size_t extension = path.find_last_of('.');
+	size_t separator = path.find_last_of("/\\");
+	if (extension == std::string::npos || (separator != std::string::npos && extension < separator)) extension = path.size();
+	return path.substr(0, extension) + "_" + std::to_string(_nbCaptures) + path.substr(extension);
+}
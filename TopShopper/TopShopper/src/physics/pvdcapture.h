@@ -0,0 +1,69 @@
+#ifndef PVDCAPTURE_H_
+#define PVDCAPTURE_H_
+
+#include "PxPhysicsAPI.h"
+#include <string>
+
+
+// DEFINITION:
+// PVD CAPTURE (1 per program, owned by the physics manager)
+// owns the PxPvd that PxCreatePhysics() gets hooked up to, and decides what it's connected to:
+//		live	- (--pvd-host IP) socket to a running PhysX Visual Debugger, connected at init and left on
+//		file	- (--pvd-capture FILE, or F10 at runtime) writes a .pxd2 file that PVD can open later, no client needed
+//				  a file capture covers a bounded number of physics steps (--pvd-frames N, 0 = until F10 again), so it can be left armed on a build box
+//				  and still only capture the steps around a spike (--pvd-capture-from STEP delays the start)
+// every new file capture in the same run gets a _1, _2, ... suffix so an earlier one never gets overwritten.
+//
+// NOTE: only does anything in PVD_ENABLED builds (the release PhysX libs don't send PVD data anyway), otherwise it just says so
+// NOTE: connecting needs a PxScene step boundary (beginStep()/endStep() call onStepBegin()/onStepEnd()), so a capture starts with the next simulate()
+
+
+struct PvdCaptureSettings {
+	std::string _host; // empty = no live connection
+	std::string _capturePath = "capture.pxd2";
+	bool _captureAtStart = false; // set by --pvd-capture
+	unsigned long long _captureFromStep = 0; // physics steps into the run before an armed capture starts
+	unsigned int _nbCaptureSteps = 600; // 10s at 60Hz, 0 = no limit
+	std::string _flags = "all"; // comma separated: debug, profile, memory, all (see PxPvdInstrumentationFlag)
+};
+
+
+
+class PvdCapture {
+public:
+	PvdCapture(physx::PxFoundation &foundation, const PvdCaptureSettings &settings);
+	virtual ~PvdCapture(); // finishes a running capture (NOTE: the PxPvd itself isn't released, it has to outlive PxPhysics)
+
+	physx::PxPvd* getPvd() { return _pvd; } // nullptr without PVD_ENABLED
+
+	void toggleCapture(); // F10
+	void startCapture(); // right away, with the next simulate()
+	void stopCapture();
+	bool isCapturing() { return _isCapturing; }
+
+	void onStepBegin(); // before simulate()
+	void onStepEnd(); // after fetchResults()
+
+	static physx::PxPvdInstrumentationFlags parseFlags(const std::string &flags); // unknown names get a WARNING and are skipped
+
+private:
+	bool connect(physx::PxPvdTransport *transport); // takes ownership of the transport (released on failure)
+	void disconnect();
+	std::string getCapturePath(); // next numbered file name
+
+	PvdCaptureSettings _settings;
+	physx::PxPvd *_pvd = nullptr;
+	physx::PxPvdTransport *_transport = nullptr;
+
+	bool _isLive = false; // connected to --pvd-host (file captures can't run meanwhile, PxPvd only has 1 transport)
+	bool _isCapturing = false;
+	bool _isArmed = false; // waiting for _captureFromStep
+	unsigned long long _nbSteps = 0; // every step since init
+	unsigned int _nbCapturedSteps = 0;
+	unsigned int _nbCaptures = 0;
+	std::string _currentPath;
+};
+
+
+
+#endif // PVDCAPTURE_H_
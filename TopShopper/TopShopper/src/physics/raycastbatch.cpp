@@ -0,0 +1,50 @@
+#include "raycastbatch.h"
+#include <iostream>
+
+using namespace physx;
+
+
+
+RaycastBatch::RaycastBatch(PxScene *physxScene, PxU32 capacity)
+	: _capacity(capacity)
+{
+	_results.resize(_capacity + 1);
+	_touches.resize(_capacity);
+	_results[_capacity] = PxRaycastQueryResult(); // overflow slot, never has a hit
+
+	PxBatchQueryDesc desc(_capacity, 0, 0);
+	desc.queryMemory.userRaycastResultBuffer = _results.data();
+	desc.queryMemory.userRaycastTouchBuffer = _touches.data();
+	desc.queryMemory.raycastTouchBufferSize = _capacity;
+	desc.preFilterShader = NULL;
+	_batchQuery = physxScene->createBatchQuery(desc);
+}
+
+
+RaycastBatch::~RaycastBatch() {
+	_batchQuery->release();
+	_batchQuery = nullptr;
+}
+
+
+
+void RaycastBatch::reset() {
+	_nbRays = 0;
+}
+
+
+PxU32 RaycastBatch::addRay(const PxVec3 &origin, const PxVec3 &unitDir, PxReal distance) {
+	if (_nbRays >= _capacity) {
+		std::cout << "WARNING: raycast batch is full (" << _capacity << " rays), ray ignored" << std::endl;
+		return _capacity;
+	}
+
+	_batchQuery->raycast(origin, unitDir, distance, 0, PxHitFlag::eDEFAULT, _filterData); // 0 touch hits = closest blocking hit only
+	return _nbRays++;
+}
+
+
+void RaycastBatch::execute() {
+	if (_nbRays == 0) return;
+	_batchQuery->execute();
+}
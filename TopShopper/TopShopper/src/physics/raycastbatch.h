@@ -0,0 +1,44 @@
+#ifndef RAYCASTBATCH_H_
+#define RAYCASTBATCH_H_
+
+#include "PxPhysicsAPI.h"
+#include <vector>
+
+
+// DEFINITION:
+// RAYCAST BATCH (1 per PxScene for the AI, owned by the physics manager)
+// every bot's navigation rays for a step get queued in here, then run as 1 PxBatchQuery instead of 1 PxScene::raycast() each:
+//		reset()		- start of the step
+//		addRay()	- returns the ray's index (rays only get queued, no results yet)
+//		execute()	- runs every queued ray at once (all with the same filter data), results stay valid until the next execute()
+// the result/touch buffers are allocated once for capacity rays, so nothing gets allocated per step.
+//
+// NOTE: addRay()/execute() are NOT thread safe, only getResult() can be called from several threads (after execute())
+// NOTE: no prefilter shader, so every hit is blocking (same as PxScene::raycast() with the default filter data)
+
+
+class RaycastBatch {
+public:
+	RaycastBatch(physx::PxScene *physxScene, physx::PxU32 capacity);
+	virtual ~RaycastBatch(); // releases the PxBatchQuery
+
+	void reset();
+	physx::PxU32 addRay(const physx::PxVec3 &origin, const physx::PxVec3 &unitDir, physx::PxReal distance);
+	void execute();
+
+	const physx::PxRaycastQueryResult& getResult(physx::PxU32 index) { return index < _nbRays ? _results[index] : _results[_capacity]; } // anything past the queued rays is a miss
+	physx::PxU32 getNbRays() { return _nbRays; }
+
+private:
+	physx::PxBatchQuery *_batchQuery = nullptr;
+	physx::PxQueryFilterData _filterData; // shared by every ray (static + dynamic shapes)
+
+	std::vector<physx::PxRaycastQueryResult> _results; // capacity + 1, the last one is a permanent miss handed out once the batch is full
+	std::vector<physx::PxRaycastHit> _touches;
+	physx::PxU32 _capacity = 0;
+	physx::PxU32 _nbRays = 0;
+};
+
+
+
+#endif // RAYCASTBATCH_H_
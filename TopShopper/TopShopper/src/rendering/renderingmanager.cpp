@@ -1,5 +1,6 @@
 #include "renderingmanager.h"
 #include "core/broker.h"
+#include "core/componentpools.h"
 #include "loading/loadingmanager.h"
 #include <iostream>
 #include <string>
@@ -13,6 +14,8 @@
 #include <sstream>
 #include <ios>
 #include <iomanip>
+#include <cmath>
+#include "utility/profiler.h"
 
 using namespace physx;
 
@@ -35,6 +38,7 @@ RenderingManager::~RenderingManager() {
 //Called upon the start of the game, to set the state of OpenGL and all subsequent rendering passes
 void RenderingManager::init() {
 	bagText = 0;
+	if (_broker->_headless) return; // NULL BACKEND: never open a window or touch GL
 	openWindow();
 	initTextRender();
 
@@ -104,22 +108,27 @@ void RenderingManager::init() {
 //handles the deletion of objects after completing the rendering of each frame as well as the updating of model positions
 //calls render scene after pushing back the 3d objects in order to render the scene again. 
 void RenderingManager::updateSeconds(double variableDeltaTime) {
+	PROFILE_SCOPE("RenderingManager::updateSeconds");
 	if (bagText > 0) {
 		bagText -= 1;
 	}
 
-	glfwGetWindowSize(_window, &windowWidth, &windowHeight);
 	if (_broker->_scene == GAME) {
-		// call LATEUPDATE() for all behaviour scripts...
-		std::vector<std::shared_ptr<Entity>> entitiesCopy = _broker->getPhysicsManager()->getActiveScene()->_entities;
-		for (std::shared_ptr<Entity> &entity : entitiesCopy) {
-			std::shared_ptr<Component> comp = entity->getComponent(ComponentTypes::BEHAVIOUR_SCRIPT);
-			if (comp != nullptr) {
-				std::shared_ptr<BehaviourScript> script = std::static_pointer_cast<BehaviourScript>(comp);
-				script->lateUpdate(variableDeltaTime);
-			}
+		_pickupAnimationSeconds += variableDeltaTime;
+
+		PROFILE_SCOPE("Rendering::scriptLateUpdate");
+		// call LATEUPDATE() for the behaviour scripts that have one (see FrameCallbacks)...
+		std::vector<BehaviourScript*> &scripts = _broker->getPhysicsManager()->getActiveScene()->_componentPools->_lateUpdates._scripts;
+		size_t nbScripts = scripts.size(); // NOTE: scripts can spawn entities in here, so don't walk past the starting size
+		for (size_t i = 0; i < nbScripts; i++) {
+			scripts[i]->lateUpdate(variableDeltaTime);
 		}
 	}
+
+	// HEADLESS (NULL BACKEND): no window or GL context, so there is nothing to draw into...
+	if (_broker->_headless) return;
+
+	glfwGetWindowSize(_window, &windowWidth, &windowHeight);
 	for (Geometry& geoDel : _objects) {
 		deleteBufferData(geoDel);
 	}
@@ -127,14 +136,20 @@ void RenderingManager::updateSeconds(double variableDeltaTime) {
 
 	int numPlayers = _broker->_nbPlayers;
 	if (_broker->_scene == TIMER || _broker->_scene == GAME || _broker->_scene == PAUSED || _broker->_scene == END_SCREEN) {
-		pushDynamicObjects();
-		if (firstRun) {
-			pushStaticObjects();
-			firstRun = false;
+		{
+			PROFILE_SCOPE("Rendering::pushObjects");
+			pushDynamicObjects();
+			if (firstRun) {
+				pushStaticObjects();
+				firstRun = false;
+			}
 		}
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		RenderShadowMap();
+		{
+			PROFILE_SCOPE("Rendering::shadowMap");
+			RenderShadowMap();
+		}
 
 		if (numPlayers == 1) {
 			RenderGameScene(0, 0, 0, windowWidth, windowHeight);
@@ -175,6 +190,7 @@ void RenderingManager::updateSeconds(double variableDeltaTime) {
 	else if (_broker->_scene == CONTROLS) {
 		RenderControls();
 	}
+	PROFILE_SCOPE("Rendering::swapBuffers");
 	glfwSwapBuffers(_window);
 }
 
@@ -216,11 +232,12 @@ void RenderingManager::RenderShadowMap() {
 //then sending the vertex info down the openGL pipeline, while utilizing the approprite shaders tied to the geometry.
 //performs multiple rendering passes in order to create shadowsm, while calculating the camera information each time it is called.
 void RenderingManager::RenderGameScene(int playerID, int viewBottomLeftx, int viewBottomLeftY, int viewTopRightX, int viewTopRightY){  
+	PROFILE_SCOPE("Rendering::gameScene");
 
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player = players[playerID];
-	std::shared_ptr<PlayerScript> script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	std::array<EntityTypes,3> listElements = script->_shoppingList_Types;
+	PlayerScript *script = static_cast<PlayerScript*>(player->getComponent(PLAYER_SCRIPT));
+	std::array<EntityTypes,3> listElements = script->shoppingListTypes();
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -354,8 +371,7 @@ void RenderingManager::RenderGameScene(int playerID, int viewBottomLeftx, int vi
 glm::mat4 RenderingManager::computeCameraPosition(int playerID, glm::vec3 &camera) {
 
 	std::shared_ptr<ShoppingCartPlayer> player = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers().at(playerID);
-	PxRigidDynamic* playerDyn = player->_actor->is<PxRigidDynamic>();
-	PxTransform playerTransform = playerDyn->getGlobalPose();
+	PxTransform playerTransform = player->getInterpolatedPose((float)_broker->_interpolationAlpha);
 	PxVec3 playerPos = playerTransform.p;
 	PxQuat playerRot = playerTransform.q;
 
@@ -466,57 +482,35 @@ void RenderingManager::loadScene1() {
 void RenderingManager::renderEndScreen() {
 
 	glViewport(0, 0, windowWidth, windowHeight);
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
-	std::shared_ptr<ShoppingCartPlayer> player = players[0];
-	std::shared_ptr<PlayerScript> script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-
-	Player scores[6];
-
-	scores[0].score = script->_points;
-	scores[0].player = "Player1 ";
-
-	player = players[1];
-	script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	scores[1].score = script->_points;
-	scores[1].player = "Player2 "; // Check if its a human or cpu
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	std::vector<Player> scores;
+	for (size_t i = 0; i < players.size(); i++) {
+		PlayerScript *script = static_cast<PlayerScript*>(players.at(i)->getComponent(PLAYER_SCRIPT));
+		scores.push_back({ script->points(), "Player" + std::to_string(i + 1) + " " }); // Check if its a human or cpu
+	}
 
-	
-	player = players[2];
-	script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	scores[2].score = script->_points;
-	scores[2].player = "Player3 "; // Check if its a human or cpu
-	
-	player = players[3];
-	script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	scores[3].score = script->_points;
-	scores[3].player = "Player4 "; // Check if its a human or cpu
-
-	player = players[4];
-	script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	scores[4].score = script->_points;
-	scores[4].player = "Player5 ";
-
-	player = players[5];
-	script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	scores[5].score = script->_points;
-	scores[5].player = "Player6 ";
-
-	std::sort(scores, scores+6, compareStruct1);
+	std::sort(scores.begin(), scores.end(), compareStruct1);
 	
 	
 	//renderText("Shopper Ranks", windowWidth*0.35, windowHeight*0.63, 1.7f, glm::vec3(0.0f, 0.0f, 0.0f));
 
-	renderText("1st: " + scores[0].player + std::to_string(scores[0].score), windowWidth*0.35f, windowHeight*0.55f, 1.5f, glm::vec3(0.83f, 0.69f, 0.22f));
-
-	renderText("2nd: " + scores[1].player + std::to_string(scores[1].score), windowWidth*0.35f, windowHeight*0.46f, 1.5f, glm::vec3(0.65f, 0.65f, 0.65f));
-
-	renderText("3rd: " + scores[2].player + std::to_string(scores[2].score), windowWidth*0.35f, windowHeight*0.38f, 1.5f, glm::vec3(0.70f, 0.36f, 0.0f));
-
-	renderText("4th: " + scores[3].player + std::to_string(scores[3].score), windowWidth*0.35f, windowHeight*0.33f, 1.0f, glm::vec3(0.0f, 0.0f, 0.0f));
-
-	renderText("5th: " + scores[4].player + std::to_string(scores[4].score), windowWidth*0.35f, windowHeight*0.29f, 1.0f, glm::vec3(0.0f, 0.0f, 0.0f));
-
-	renderText("6th: " + scores[5].player + std::to_string(scores[5].score), windowWidth*0.35f, windowHeight*0.25f, 1.0f, glm::vec3(0.0f, 0.0f, 0.0f));
+	// only the top 6 fit on the results screen (there can be up to 64 carts)...
+	static const struct {
+		const char *_rank;
+		float _y;
+		float _scale;
+		glm::vec3 _color;
+	} RANK_ROWS[] = {
+		{ "1st: ", 0.55f, 1.5f, glm::vec3(0.83f, 0.69f, 0.22f) },
+		{ "2nd: ", 0.46f, 1.5f, glm::vec3(0.65f, 0.65f, 0.65f) },
+		{ "3rd: ", 0.38f, 1.5f, glm::vec3(0.70f, 0.36f, 0.0f) },
+		{ "4th: ", 0.33f, 1.0f, glm::vec3(0.0f, 0.0f, 0.0f) },
+		{ "5th: ", 0.29f, 1.0f, glm::vec3(0.0f, 0.0f, 0.0f) },
+		{ "6th: ", 0.25f, 1.0f, glm::vec3(0.0f, 0.0f, 0.0f) }
+	};
+	for (size_t i = 0; i < scores.size() && i < 6; i++) {
+		renderText(RANK_ROWS[i]._rank + scores[i].player + std::to_string(scores[i].score), windowWidth*0.35f, windowHeight*RANK_ROWS[i]._y, RANK_ROWS[i]._scale, RANK_ROWS[i]._color);
+	}
 
 	renderText("Menu", GLfloat(windowWidth*0.466f), GLfloat(windowHeight*0.106f), 1.0f, glm::vec3(0.0f, 0.0f, 0.0f));
 	renderSprite(*_buttonHighlightSprite, -0.15f, -0.85f, 0.15f, -0.65f);
@@ -713,11 +707,12 @@ void RenderingManager::RenderTimer() {
 
 //TODO: *****needs to retrieve all the other players in the game to render to the side of the screen 
 void RenderingManager::renderHud(int playerID) {
+	PROFILE_SCOPE("Rendering::hud");
 
-	std::vector<std::shared_ptr<ShoppingCartPlayer>> players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
+	const std::vector<std::shared_ptr<ShoppingCartPlayer>> &players = _broker->getPhysicsManager()->getActiveScene()->getAllShoppingCartPlayers();
 	std::shared_ptr<ShoppingCartPlayer> player = players[playerID];
-	std::shared_ptr<PlayerScript> script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-	int points = script->_points;
+	PlayerScript *script = static_cast<PlayerScript*>(player->getComponent(PLAYER_SCRIPT));
+	int points = script->points();
 	int boost = script->getNBBoosts();
 
 
@@ -730,9 +725,9 @@ void RenderingManager::renderHud(int playerID) {
 	//render the input players shopping list on the bottom of the screen
 	float offset = 0.10f;
 	int i = 0;
-	for (EntityTypes eType : script->_shoppingList_Types) {
+	for (EntityTypes eType : script->shoppingListTypes()) {
 
-		if (script->_shoppingList_Flags[i]) {
+		if (script->shoppingListFlags()[i]) {
 			renderSprite(*getSpriteTexture(EntityTypes::CHECK_MARK), -0.15f + (offset*i), -0.9f, -0.05f + (offset*i), -0.75f);
 		}
 		renderSprite(*getSpriteTexture(eType), -0.15f + (offset*i), -0.9f, -0.05f + (offset*i), -0.75f);
@@ -749,6 +744,7 @@ void RenderingManager::renderHud(int playerID) {
 	//Render the other player's lists and points to the side of the input player's screen
 	std::vector<int> otherPlayerIDs;
 	for (int i = 0; i < players.size(); i ++) {
+		if (otherPlayerIDs.size() == 5) break; // the side of the screen only fits 5 (there can be up to 64 carts)
 		if (i != playerID) {
 			otherPlayerIDs.push_back(i);
 		}
@@ -763,15 +759,15 @@ void RenderingManager::renderHud(int playerID) {
 	for (int otherPlayerID : otherPlayerIDs) {
 
 		player = players[otherPlayerID];
-		script = std::static_pointer_cast<PlayerScript>(player->getComponent(PLAYER_SCRIPT));
-		points = script->_points;
+		script = static_cast<PlayerScript*>(player->getComponent(PLAYER_SCRIPT));
+		points = script->points();
 
 
 		int i = 0;
 		offset = 0.07f;
-		for (EntityTypes eType : script->_shoppingList_Types) {
+		for (EntityTypes eType : script->shoppingListTypes()) {
 
-			if (script->_shoppingList_Flags[i]) {
+			if (script->shoppingListFlags()[i]) {
 
 				renderSprite(*getSpriteTexture(EntityTypes::CHECK_MARK), 0.69f + (offset*i), 0.55f + shoppingListOffSetAccum, 0.76f + (offset*i), 0.70f + shoppingListOffSetAccum);
 			}
@@ -1017,21 +1013,89 @@ void RenderingManager::pushStaticObjects() {
 
 
 
+/* Spin + bob for resting pickups, from the match time and a per-instance phase (so neighbouring pickups don't move in lockstep)
+* loose (solid) pickups are real rigid bodies and get drawn at their simulated pose
+*/
+PxTransform RenderingManager::getPickupDisplayPose(Entity *entity, const PxTransform &pose) {
+	static const PxVec3 SPIN_AXIS = PxVec3(1.0f, 5.0f, 1.0f).getNormalized(); // same spin the pickups used to get from their angular velocity
+	static const float SPIN_SPEED = PxVec3(1.0f, 5.0f, 1.0f).magnitude(); // rad/s
+	static const float BOB_HEIGHT = 0.5f;
+	static const float BOB_SPEED = 2.0f; // rad/s
+	static const float PHASE_STEP = 2.39996f; // golden angle, spreads the phases of consecutive handle slots
+
+	EntityTypes tag = entity->getTag();
+	if (tag < EntityTypes::MILK || tag > EntityTypes::SPARE_CHANGE) return pose;
+
+	Component *comp = entity->getComponent(ComponentTypes::PICKUP_SCRIPT);
+	if (comp != nullptr && static_cast<PickupScript*>(comp)->isSolid()) return pose;
+
+	// NOTE: wrapped in double before going to float, so a long session doesn't make the motion jitter
+	float phase = entity->_handle._slot * PHASE_STEP;
+	float spinAngle = (float)fmod(SPIN_SPEED * _pickupAnimationSeconds, 2.0 * PxPi) + phase;
+	float bobAngle = (float)fmod(BOB_SPEED * _pickupAnimationSeconds, 2.0 * PxPi) + phase;
+	PxQuat spin(spinAngle, SPIN_AXIS);
+	PxVec3 bob(0.0f, BOB_HEIGHT * PxSin(bobAngle), 0.0f);
+
+	return PxTransform(pose.p + bob, pose.q * spin);
+}
+
+
+
 /* Pushes the dyanamic objects to be rendered, these objects are cleared each frame and should be pushed back every frame
 */
 void RenderingManager::pushDynamicObjects() {
-	for (const std::shared_ptr<Entity> &entity : _broker->getPhysicsManager()->getActiveScene()->_entities) {
-		PxRigidActor *actor = entity->_actor->is<PxRigidActor>();
-		PxTransform transform = actor->getGlobalPose();
+	const float alpha = (float)_broker->_interpolationAlpha;
+	std::shared_ptr<GameScene> scene = _broker->getPhysicsManager()->getActiveScene();
+	const size_t nbEntities = scene->_entities.size();
+
+	// BUILD THE RENDER LIST (jobs): geometry + model matrices for a chunk of entities per job, nothing in there touches GL...
+	size_t nbChunks = (nbEntities + RENDER_LIST_CHUNK_SIZE - 1) / RENDER_LIST_CHUNK_SIZE;
+	if (_dynamicObjectChunks.size() < nbChunks) _dynamicObjectChunks.resize(nbChunks);
+	{
+		PROFILE_SCOPE("Rendering::buildRenderList");
+		_broker->getJobSystem()->parallelFor(nbChunks, 1, [this, alpha, nbEntities](size_t begin, size_t end) {
+			for (size_t chunk = begin; chunk < end; chunk++) {
+				buildDynamicObjects(chunk * RENDER_LIST_CHUNK_SIZE, std::min(nbEntities, (chunk + 1) * RENDER_LIST_CHUNK_SIZE), alpha, _dynamicObjectChunks[chunk]);
+			}
+		});
+	}
+
+	// UPLOAD (main thread only, it owns the GL context), chunk by chunk so the draw order stays the entity order...
+	for (size_t chunk = 0; chunk < nbChunks; chunk++) {
+		for (Geometry &geo : _dynamicObjectChunks[chunk]) {
+			assignBuffers(geo);
+			setBufferData(geo);
+			_objects.push_back(std::move(geo));
+		}
+		_dynamicObjectChunks[chunk].clear();
+	}
+
+	// the gradient shader shows the hot potato holder's timer...
+	for (PlayerScript *playerScript : scene->_componentPools->_players._scripts) {
+		if (playerScript->hasHotPotato()) _gradientDegree = playerScript->hotPotatoTimer();
+	}
+}
+
+
+// appends the geometry of entities [begin, end) to objects, without any GL buffers yet
+// NOTE: runs on the job system, so it must only read the scene
+void RenderingManager::buildDynamicObjects(size_t begin, size_t end, float alpha, std::vector<Geometry> &objects) {
+	const std::vector<std::shared_ptr<Entity>> &entities = _broker->getPhysicsManager()->getActiveScene()->_entities;
+	for (size_t i = begin; i < end; i++) {
+		const std::shared_ptr<Entity> &entity = entities[i];
+		PxTransform transform = entity->getInterpolatedPose(alpha);
 		PxVec3 pos = transform.p;
 		const PxQuat rot = transform.q;
 		EntityTypes tag = entity->getTag();
 
 		Geometry geo;
 
+		// NOTE: only the mesh spins/bobs, the spotlight pillar below stays put
+		PxTransform displayTransform = getPickupDisplayPose(entity.get(), transform);
+
 		glm::mat4 model;
-		PxMat44 rotation = PxMat44(rot);
-		PxMat44 translation = PxMat44(PxMat33(PxIdentity), pos);
+		PxMat44 rotation = PxMat44(displayTransform.q);
+		PxMat44 translation = PxMat44(PxMat33(PxIdentity), displayTransform.p);
 		PxMat44	pxModel = translation * rotation;
 		model = glm::mat4(glm::vec4(pxModel.column0.x, pxModel.column0.y, pxModel.column0.z, pxModel.column0.w),
 			glm::vec4(pxModel.column1.x, pxModel.column1.y, pxModel.column1.z, pxModel.column1.w),
@@ -1068,7 +1132,7 @@ void RenderingManager::pushDynamicObjects() {
 				continue;
 			}
 
-			switch (vehicleID) {
+			switch (vehicleID % 6) { // 6 cart colours, they repeat past 6 carts
 				case 0:
 					geo = *(_broker->getLoadingManager()->getGeometry(GeometryTypes::CART_RED_GEO_NO_INDEX));
 					geo.texture = *_shoppingCartRed;
@@ -1120,18 +1184,14 @@ void RenderingManager::pushDynamicObjects() {
 
 				geoWheel.model = model;
 				geoWheel.drawMode = GL_TRIANGLES;
-				assignBuffers(geoWheel);
-				setBufferData(geoWheel);
-				_objects.push_back(geoWheel);
+				objects.push_back(geoWheel);
 			}
 
 			// HOT POTATO RENDERING...
-			std::shared_ptr<PlayerScript> playerScript = std::static_pointer_cast<PlayerScript>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
-			if (playerScript->_hasHotPotato) {
+			PlayerScript *playerScript = static_cast<PlayerScript*>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
+			if (playerScript->hasHotPotato()) {
 				Geometry geoPotato = *(_broker->getLoadingManager()->getGeometry(GeometryTypes::HOT_POTATO_GEO_NO_INDEX));
 				geoPotato.color = glm::vec3(3.0f, 4.0f, 3.0f);
-				
-				_gradientDegree = playerScript->_hotPotatoTimer;
 
 				glm::mat4 model;
 				PxMat44 rotation = PxMat44(rot);
@@ -1147,9 +1207,7 @@ void RenderingManager::pushDynamicObjects() {
 				geoPotato.gradientShader = true;
 
 				geoPotato.drawMode = GL_TRIANGLES;
-				assignBuffers(geoPotato);
-				setBufferData(geoPotato);
-				_objects.push_back(geoPotato);
+				objects.push_back(geoPotato);
 			}
 
 
@@ -1172,13 +1230,11 @@ void RenderingManager::pushDynamicObjects() {
 				geoShield.EntityType = EntityTypes::SHIELD;
 
 				geoShield.drawMode = GL_TRIANGLES;
-				assignBuffers(geoShield);
-				setBufferData(geoShield);
-				_objects.push_back(geoShield);
+				objects.push_back(geoShield);
 			}
 
 			// SPOTLIGHT UH MOONLIGHT UH RENDERING...
-			//std::shared_ptr<PlayerScript> playerScript = std::static_pointer_cast<PlayerScript>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
+			//PlayerScript *playerScript = static_cast<PlayerScript*>(player->getComponent(ComponentTypes::PLAYER_SCRIPT));
 	
 			// POINTER RENDERING...
 			Geometry geoPointer = *(_broker->getLoadingManager()->getGeometry(GeometryTypes::POINTER_GEO_NO_INDEX));
@@ -1217,7 +1273,7 @@ void RenderingManager::pushDynamicObjects() {
 					default:
 						break;
 				}
-				otherPos = players.at(i)->_actor->is<PxRigidDynamic>()->getGlobalPose().p;
+				otherPos = players.at(i)->getInterpolatedPose(alpha).p;
 				PxVec3 forward = rot.getBasisVector2();
 				PxVec3 cartForward = forward;
 				PxVec3 cartToCart = otherPos - pos;
@@ -1244,10 +1300,8 @@ void RenderingManager::pushDynamicObjects() {
 				geoPointer.model = model;
 				geoPointer.drawMode = GL_TRIANGLES;
 
-				assignBuffers(geoPointer);
-				setBufferData(geoPointer);
 				geoPointer.hasShadow = false;
-				_objects.push_back(geoPointer);
+				objects.push_back(geoPointer);
 				yOffset += 0.5f;
 			}
 			break;
@@ -1260,9 +1314,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::WATER:
@@ -1273,9 +1325,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::COLA:
@@ -1286,9 +1336,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::APPLE:
@@ -1299,9 +1347,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::WATERMELON:
@@ -1312,9 +1358,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::BANANA:
@@ -1325,9 +1369,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::CARROT:
@@ -1338,9 +1380,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::EGGPLANT:
@@ -1351,9 +1391,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::BROCCOLI:
@@ -1364,9 +1402,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::MYSTERY_BAG:
@@ -1383,9 +1419,7 @@ void RenderingManager::pushDynamicObjects() {
 			pillarGeo.model = spotlightModel;
 			pillarGeo.isTransparent = true;
 			pillarGeo.hasShadow = false;
-			assignBuffers(pillarGeo);
-			setBufferData(pillarGeo);
-			_objects.push_back(pillarGeo);
+			objects.push_back(pillarGeo);
 			break;
 		}
 		case EntityTypes::SPARE_CHANGE:
@@ -1401,10 +1435,7 @@ void RenderingManager::pushDynamicObjects() {
 
 		geo.model = model;
 		geo.drawMode = GL_TRIANGLES;
-
-		assignBuffers(geo);
-		setBufferData(geo);
-		_objects.push_back(geo);
+		objects.push_back(geo);
 	}
 }
 
@@ -1762,6 +1793,7 @@ void RenderingManager::initTextRender() {
 
 
 void RenderingManager::cleanup() {
+	if (_broker->_headless) return;
 	glfwTerminate();
 }
 
@@ -6,6 +6,7 @@
 #define SHADOW_MAP_SIZE_SINGLE_PLAYER 4096
 #define SHADOW_MAP_SIZE_MULTI_PLAYER 1500
 #define	FULL_SCREEN false
+#define RENDER_LIST_CHUNK_SIZE 16 // entities per render list job
 
 
 //**Must include glad and GLFW in this order or it breaks**
@@ -116,7 +117,7 @@ public:
 	GLFWwindow* getWindow();
 	void QueryGLVersion();
 	void pushStaticObjects();
-	void pushDynamicObjects();
+	void pushDynamicObjects(); // builds the render list on the job system, then uploads it on the main thread
 	std::map<GLchar, Character> Characters;
 
 	int windowHeight;
@@ -141,6 +142,15 @@ private:
 	float _gradientDegree;
 	void openWindow();
 
+	// DYNAMIC RENDER LIST...
+	std::vector<std::vector<Geometry>> _dynamicObjectChunks; // 1 per RENDER_LIST_CHUNK_SIZE entities, filled by jobs and emptied by the upload
+	void buildDynamicObjects(size_t begin, size_t end, float alpha, std::vector<Geometry> &objects); // entities [begin, end), no GL calls
+
+	// PICKUP ANIMATION...
+	// resting pickups are kinematic triggers that never move (see PhysicsManager::setPickupSolid()), the spin + bob only happens here
+	double _pickupAnimationSeconds = 0.0; // only advances while a match is being played
+	physx::PxTransform getPickupDisplayPose(Entity *entity, const physx::PxTransform &pose);
+
 	MyTexture *_borderSpriteBlack = new MyTexture();
 	MyTexture *_borderSpriteBlue = new MyTexture();
 	MyTexture *_borderSpriteRed = new MyTexture();
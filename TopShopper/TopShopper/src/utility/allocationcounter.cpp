@@ -0,0 +1,78 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+static std::atomic<uint64_t> gNbAllocations{ 0 };
+#endif // ALLOCATION_COUNTER_ENABLED
+
+
+bool AllocationCounter::isEnabled() {
+	#ifdef ALLOCATION_COUNTER_ENABLED
+	return true;
+	#else
+	return false;
+	#endif // ALLOCATION_COUNTER_ENABLED
+}
+
+
+uint64_t AllocationCounter::getNbAllocations() {
+	#ifdef ALLOCATION_COUNTER_ENABLED
+	return gNbAllocations.load(std::memory_order_relaxed);
+	#else
+	return 0;
+	#endif // ALLOCATION_COUNTER_ENABLED
+}
+
+
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+// GLOBAL OPERATOR NEW/DELETE REPLACEMENTS...
+
+void* operator new(size_t size) {
+	gNbAllocations.fetch_add(1, std::memory_order_relaxed);
+	void *ptr = malloc(size > 0 ? size : 1);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	gNbAllocations.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+	return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+	free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept {
+	free(ptr);
+}
+#endif // ALLOCATION_COUNTER_ENABLED
@@ -0,0 +1,22 @@
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <cstdint>
+
+// HEAP ALLOCATION COUNTER...
+// global operator new/delete are replaced (see allocationcounter.cpp) so every C++ heap allocation in the program bumps a counter.
+// USAGE: read getNbAllocations() before and after a block of work, the difference is how many allocations it made.
+// NOTE: PhysX allocates through its own PxAllocatorCallback, so its internal allocations aren't counted (only ours)
+// NOTE: only compiled in with ALLOCATION_COUNTER_ENABLED (only the Profile configuration defines it, Debug/Release ship with the standard allocator), otherwise the standard operator new/delete are left alone
+//		 and getNbAllocations() is always 0. when compiled in, the counter is a relaxed atomic (the increment is noise next to the malloc itself)
+
+
+class AllocationCounter {
+public:
+	static bool isEnabled(); // compiled in?
+	static uint64_t getNbAllocations(); // total nb of operator new calls so far (any thread)
+};
+
+
+
+#endif // ALLOCATIONCOUNTER_H_
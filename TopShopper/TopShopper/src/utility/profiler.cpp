@@ -0,0 +1,102 @@
+#include "profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+
+std::atomic<bool> gProfilerEnabled{ false };
+
+
+// PER-THREAD RING BUFFER...
+// only the owning thread ever writes into it, so recording never takes a lock.
+struct ProfilerRingBuffer {
+	ProfilerRingBuffer(int threadID) : _threadID(threadID) {}
+
+	int _threadID;
+	std::atomic<uint64_t> _writeIndex{ 0 }; // total number of events ever recorded (wraps around the buffer)
+	Profiler::Event _events[PROFILER_RING_BUFFER_SIZE];
+};
+
+// every buffer ever created (buffers are never freed, since a dump might happen after their thread has exited)
+std::vector<ProfilerRingBuffer*> gProfilerRingBuffers;
+std::mutex gProfilerRingBuffersMutex;
+
+const std::chrono::steady_clock::time_point gProfilerEpoch = std::chrono::steady_clock::now();
+
+
+// lazily registers a buffer the first time a thread records something...
+static ProfilerRingBuffer* getThreadRingBuffer() {
+	thread_local ProfilerRingBuffer *ringBuffer = nullptr;
+	if (ringBuffer == nullptr) {
+		std::lock_guard<std::mutex> lock(gProfilerRingBuffersMutex);
+		ringBuffer = new ProfilerRingBuffer((int)gProfilerRingBuffers.size());
+		gProfilerRingBuffers.push_back(ringBuffer);
+	}
+	return ringBuffer;
+}
+
+
+
+void Profiler::setEnabled(bool enabled) {
+	gProfilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+int64_t Profiler::nowMicros() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - gProfilerEpoch).count();
+}
+
+
+void Profiler::record(const char *name, int64_t startMicros, int64_t endMicros) {
+	ProfilerRingBuffer *ringBuffer = getThreadRingBuffer();
+	uint64_t index = ringBuffer->_writeIndex.load(std::memory_order_relaxed);
+	Event &e = ringBuffer->_events[index & (PROFILER_RING_BUFFER_SIZE - 1)];
+	e.name = name;
+	e.startMicros = startMicros;
+	e.durationMicros = endMicros - startMicros;
+	ringBuffer->_writeIndex.store(index + 1, std::memory_order_release);
+}
+
+
+void Profiler::clear() {
+	std::lock_guard<std::mutex> lock(gProfilerRingBuffersMutex);
+	for (ProfilerRingBuffer *ringBuffer : gProfilerRingBuffers) {
+		ringBuffer->_writeIndex.store(0, std::memory_order_release);
+	}
+}
+
+
+// writes all buffered events in the chrome trace event format ("X" = complete event w/ duration)...
+bool Profiler::dumpChromeTrace(const std::string &filename) {
+	std::ofstream file(filename);
+	if (!file.is_open()) {
+		std::cout << "ERROR: could not open profiler output file " << filename << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(gProfilerRingBuffersMutex);
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	size_t nbEvents = 0;
+	for (ProfilerRingBuffer *ringBuffer : gProfilerRingBuffers) {
+		uint64_t end = ringBuffer->_writeIndex.load(std::memory_order_acquire);
+		uint64_t begin = end > PROFILER_RING_BUFFER_SIZE ? end - PROFILER_RING_BUFFER_SIZE : 0;
+		for (uint64_t i = begin; i < end; i++) {
+			const Event &e = ringBuffer->_events[i & (PROFILER_RING_BUFFER_SIZE - 1)];
+			if (!first) file << ",";
+			first = false;
+			file << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ringBuffer->_threadID
+				<< ",\"ts\":" << e.startMicros << ",\"dur\":" << e.durationMicros << "}";
+			nbEvents++;
+		}
+	}
+	file << "\n]}\n";
+
+	std::cout << "PROFILER: wrote " << nbEvents << " events to " << filename << std::endl;
+	return true;
+}
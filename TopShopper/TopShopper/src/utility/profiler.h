@@ -0,0 +1,62 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+// SCOPED-TIMER FRAME PROFILER...
+// USAGE: put PROFILE_SCOPE("Some::phase"); at the top of a block, the time until the end of that block gets recorded.
+// each thread records into its own fixed size ring buffer (oldest events get overwritten), call Profiler::dumpChromeTrace() to write
+// everything out as JSON that can be opened in chrome://tracing (or https://ui.perfetto.dev)
+// NOTE: compiled in with PROFILER_ENABLED (see project preprocessor definitions), but recording is OFF at runtime until Profiler::setEnabled(true)
+//		 when off, each scope only costs a single (relaxed atomic) bool check. if PROFILER_ENABLED is not defined, the macros compile to nothing.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#define PROFILER_RING_BUFFER_SIZE 65536 // events per thread (must be a power of 2)
+
+
+extern std::atomic<bool> gProfilerEnabled; // read inline by every scope (from job threads too, relaxed loads are enough)
+
+
+class Profiler {
+public:
+	struct Event {
+		const char *name = nullptr; // NOTE: must point to a string literal (we only store the pointer)
+		int64_t startMicros = 0;
+		int64_t durationMicros = 0;
+	};
+
+	static void setEnabled(bool enabled);
+	static bool isEnabled() { return gProfilerEnabled.load(std::memory_order_relaxed); }
+
+	static int64_t nowMicros(); // monotonic, relative to program start
+	static void record(const char *name, int64_t startMicros, int64_t endMicros); // appends to the calling thread's ring buffer
+
+	static void clear();
+	static bool dumpChromeTrace(const std::string &filename); // NOTE: call from the main thread between frames (when no other thread is recording)
+};
+
+
+class ProfileScope {
+public:
+	ProfileScope(const char *name) : _name(name), _startMicros(gProfilerEnabled.load(std::memory_order_relaxed) ? Profiler::nowMicros() : -1) {}
+	~ProfileScope() {
+		if (_startMicros >= 0) Profiler::record(_name, _startMicros, Profiler::nowMicros());
+	}
+
+private:
+	const char *_name;
+	int64_t _startMicros;
+};
+
+
+#ifdef PROFILER_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif // PROFILER_ENABLED
+
+
+#endif // PROFILER_H_
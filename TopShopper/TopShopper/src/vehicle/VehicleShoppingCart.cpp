@@ -1,5 +1,6 @@
 #include "vehicleshoppingcart.h"
 #include "physics/physicsmanager.h"
+#include "core/snapshot.h"
 #include <iostream>
 
 
@@ -335,6 +336,119 @@ void VehicleShoppingCart::tickBashProtectionTimer(double fixedDeltaTime) {
 }
 
 
+void VehicleShoppingCart::resetState(const PxTransform &transform) {
+	// PHYSX STATE...
+	PxRigidDynamic *actor = _vehicle4W->getRigidDynamicActor();
+	actor->setGlobalPose(transform);
+	actor->setLinearVelocity(PxVec3(0.0f, 0.0f, 0.0f));
+	actor->setAngularVelocity(PxVec3(0.0f, 0.0f, 0.0f));
+	_vehicle4W->setToRestState();
+	_vehicle4W->mDriveDynData.forceGearChange(PxVehicleGearsData::eFIRST);
+
+	// GAMEPLAY STATE (same as a freshly constructed cart)...
+	clearRawInputDataKeyboard();
+	clearRawInputDataController();
+	_isKeyAndMouseControlled = true;
+	_isAirborne = false;
+	_isTurboing = false;
+	_isBashProtected = false;
+	_bashProtectionTimer = -1.0;
+	_turboFuel = 4.0f;
+	_nbBoosts = 4;
+	_wasHitFrameTimer = 0;
+}
+
+
+void VehicleShoppingCart::writeSnapshot(SnapshotWriter &writer) {
+	// DRIVE...
+	PxVehicleDriveDynData &drive = _vehicle4W->mDriveDynData;
+	for (PxU32 i = 0; i < PxVehicleDrive4WControl::eMAX_NB_DRIVE4W_ANALOG_INPUTS; i++) {
+		writer.write(drive.getAnalogInput(i));
+	}
+	writer.write(drive.getUseAutoGears());
+	writer.write(drive.getGearUp());
+	writer.write(drive.getGearDown());
+	writer.write(drive.getCurrentGear());
+	writer.write(drive.getTargetGear());
+	writer.write(drive.getEngineRotationSpeed());
+	writer.write(drive.getGearSwitchTime());
+	writer.write(drive.getAutoBoxSwitchTime());
+
+	// WHEELS...
+	PxU32 nbWheels = _vehicle4W->mWheelsSimData.getNbWheels();
+	writer.write(nbWheels);
+	for (PxU32 i = 0; i < nbWheels; i++) {
+		writer.write(_vehicle4W->mWheelsDynData.getWheelRotationSpeed(i));
+		writer.write(_vehicle4W->mWheelsDynData.getWheelRotationAngle(i));
+	}
+
+	// GAMEPLAY...
+	writer.write(_turboFuel);
+	writer.write(_nbBoosts);
+	writer.write(_wasHitFrameTimer);
+	writer.write(_isAirborne);
+	writer.write(_isKeyAndMouseControlled);
+	writer.write(_isTurboing);
+	writer.write(_isBashProtected);
+	writer.write(_bashProtectionTimer);
+}
+
+
+bool VehicleShoppingCart::readSnapshot(SnapshotReader &reader) {
+	// DRIVE...
+	PxVehicleDriveDynData &drive = _vehicle4W->mDriveDynData;
+	for (PxU32 i = 0; i < PxVehicleDrive4WControl::eMAX_NB_DRIVE4W_ANALOG_INPUTS; i++) {
+		PxReal analogInput = 0.0f;
+		reader.read(analogInput);
+		drive.setAnalogInput(i, analogInput);
+	}
+	bool useAutoGears = false, gearUp = false, gearDown = false;
+	PxU32 currentGear = 0, targetGear = 0;
+	PxReal engineRotationSpeed = 0.0f;
+	reader.read(useAutoGears);
+	reader.read(gearUp);
+	reader.read(gearDown);
+	reader.read(currentGear);
+	reader.read(targetGear);
+	reader.read(engineRotationSpeed);
+	reader.read(drive.mGearSwitchTime); // no setters for these 2 timers
+	reader.read(drive.mAutoBoxSwitchTime);
+	drive.setUseAutoGears(useAutoGears);
+	drive.setGearUp(gearUp);
+	drive.setGearDown(gearDown);
+	drive.setCurrentGear(currentGear);
+	drive.setTargetGear(targetGear);
+	drive.setEngineRotationSpeed(engineRotationSpeed);
+
+	// WHEELS...
+	PxU32 nbWheels = 0;
+	reader.read(nbWheels);
+	if (nbWheels != _vehicle4W->mWheelsSimData.getNbWheels()) {
+		std::cout << "ERROR: snapshot wheel count doesn't match the vehicle" << std::endl;
+		return false;
+	}
+	for (PxU32 i = 0; i < nbWheels; i++) {
+		PxReal rotationSpeed = 0.0f, rotationAngle = 0.0f;
+		reader.read(rotationSpeed);
+		reader.read(rotationAngle);
+		_vehicle4W->mWheelsDynData.setWheelRotationSpeed(i, rotationSpeed);
+		_vehicle4W->mWheelsDynData.setWheelRotationAngle(i, rotationAngle);
+	}
+
+	// GAMEPLAY...
+	reader.read(_turboFuel);
+	reader.read(_nbBoosts);
+	reader.read(_wasHitFrameTimer);
+	reader.read(_isAirborne);
+	reader.read(_isKeyAndMouseControlled);
+	reader.read(_isTurboing);
+	reader.read(_isBashProtected);
+	reader.read(_bashProtectionTimer);
+
+	return !reader.hasFailed();
+}
+
+
 
 
 void VehicleShoppingCart::consumeTurbo(double fixedDeltaTime) {
@@ -4,6 +4,8 @@
 #include "PxPhysicsAPI.h"
 #include "snippetvehiclecommon/SnippetVehicleCreate.h"
 
+class SnapshotWriter;
+class SnapshotReader;
 
 
 class VehicleShoppingCart {
@@ -33,6 +35,13 @@ class VehicleShoppingCart {
 		void setBashProtected();
 		void tickBashProtectionTimer(double fixedDeltaTime);
 
+		void resetState(const physx::PxTransform &transform); // WARM RESTART: puts the cart back at a spawn point w/ default gameplay state (reuses the cooked meshes instead of rebuilding the vehicle)
+
+		// SNAPSHOTS: drive/wheel state + turbo/bash timers (the rigid body itself is handled by the physics manager)
+		// NOTE: raw inputs aren't saved since they get rebuilt from input/AI every step before being smoothed into the drive state
+		void writeSnapshot(SnapshotWriter &writer);
+		bool readSnapshot(SnapshotReader &reader);
+
 
 		std::vector<physx::PxShape*> _wheelShapes;
 